@@ -0,0 +1,82 @@
+// Writes a compile_commands.json-sized file and times random line jumps:
+// the old jumpToLine, which re-read the file from byte 0 with getline on
+// every call, against fileHandler's line index. The first indexed jump
+// pays for the scan and is reported on its own.
+//
+//   line_seek [lines=200000] [jumps=200]
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "files.hpp"
+
+namespace {
+
+const std::filesystem::path FILE_NAME = "line_seek.txt";
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The jumpToLine this benchmark replaced
+void getlineJump(std::fstream& file, size_t lineNumber) {
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    std::string skipped;
+    for (size_t i = 1; i < lineNumber; ++i) std::getline(file, skipped);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t lines = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t jumps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    {
+        std::ofstream out(FILE_NAME);
+        for (size_t i = 0; i < lines; ++i)
+            out << "  {\"directory\": \"/src/build\", \"command\": \"c++ -O2 -Iinclude -c src/unit" << i
+                << ".cpp -o unit" << i << ".o\", \"file\": \"src/unit" << i << ".cpp\"},\n";
+    }
+    std::mt19937 rng(42);
+    std::vector<size_t> targets(jumps);
+    for (auto& t : targets) t = std::uniform_int_distribution<size_t>(1, lines)(rng);
+    std::cout << "File: " << std::filesystem::file_size(FILE_NAME) / 1024 << " KiB, " << lines << " lines, "
+              << jumps << " random jumps" << std::endl;
+
+    std::string line;
+    size_t check = 0;
+    std::fstream plain(FILE_NAME, std::ios::in);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t : targets) {
+        getlineJump(plain, t);
+        std::getline(plain, line);
+        check += line.size();
+    }
+    double getlineMs = msSince(start);
+
+    Harbour::FH::fileHandler handler(FILE_NAME, "r");
+    handler.open();
+    start = std::chrono::steady_clock::now();
+    handler.jumpToLine(1);
+    double indexMs = msSince(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t t : targets) {
+        handler.jumpToLine(t);
+        std::getline(handler.getStream(), line);
+        check -= line.size();
+    }
+    double indexedMs = msSince(start);
+    handler.close();
+    std::filesystem::remove(FILE_NAME);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  getline from byte 0      " << std::setw(10) << getlineMs / jumps << " ms/jump" << std::endl;
+    std::cout << "  line index (build once)  " << std::setw(10) << indexMs << " ms" << std::endl;
+    std::cout << "  line index               " << std::setw(10) << indexedMs / jumps << " ms/jump" << std::endl;
+    return check == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Parses a synthetic .hrbr with many dependency entries and reports the
+// median time per parse for Harbour's manifest reader and, when CMake found
+// it, nlohmann/json doing the same extraction.
+//
+//   manifest_parse [dependencies=20000] [iterations=25]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Manifest.hpp"
+#include "json.hpp"
+#ifdef HARBOUR_BENCH_NLOHMANN
+#include <nlohmann/json.hpp>
+#endif
+
+namespace {
+
+std::string syntheticManifest(size_t dependencies) {
+    std::string text = "{\n  \"info\": {\"name\": \"monorepo\", \"type\": \"binary\", \"version\": \"1.0.0\"},\n";
+    text += "  \"scripts\": {\n";
+    for (size_t i = 0; i < 64; ++i)
+        text += "    \"task" + std::to_string(i) + "\": [\"echo building part " + std::to_string(i) +
+                "\", \"cp ./lib/part" + std::to_string(i) + ".a /usr/local/lib/\"],\n";
+    text += "    \"run\": \"./bin/monorepo\"\n  },\n  \"dependencies\": {\n";
+    for (size_t i = 0; i < dependencies; ++i) {
+        text += "    \"org-" + std::to_string(i % 97) + "/package-with-a-long-name-" + std::to_string(i) + "\": \"^" +
+                std::to_string(i % 13) + "." + std::to_string(i % 7) + "." + std::to_string(i % 5) + "\"";
+        text += i + 1 < dependencies ? ",\n" : "\n";
+    }
+    return text + "  }\n}\n";
+}
+
+double medianMs(size_t iterations, const std::function<size_t()>& run, size_t& check) {
+    std::vector<double> samples;
+    for (size_t i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        check = run();
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void report(const std::string& name, double ms, size_t bytes, size_t entries) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << ms << " ms" << std::setprecision(1) << std::setw(10) << bytes / ms / 1e3
+              << " MB/s   (" << entries << " dependencies)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t dependencies = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 25;
+    std::string text = syntheticManifest(dependencies);
+    std::cout << "Manifest: " << text.size() / 1024 << " KiB, " << dependencies << " dependencies, median of "
+              << iterations << " runs" << std::endl;
+
+    size_t entries = 0;
+    double ms = medianMs(iterations, [&] {
+        Harbour::Json::Value root;
+        Harbour::Json::parse(text, root);
+        return root.find("dependencies")->members.size();
+    }, entries);
+    report("Harbour::Json (DOM only)", ms, text.size(), entries);
+
+    ms = medianMs(iterations, [&] {
+        Harbour::Project::Manifest manifest;
+        std::string error;
+        manifest.parse(text, error);
+        return manifest.dependencies.size();
+    }, entries);
+    report("Harbour Manifest", ms, text.size(), entries);
+
+#ifdef HARBOUR_BENCH_NLOHMANN
+    ms = medianMs(iterations, [&] {
+        auto root = nlohmann::json::parse(text);
+        std::vector<std::pair<std::string, std::string>> deps;
+        for (auto& [name, range] : root["dependencies"].items()) deps.emplace_back(name, range.get<std::string>());
+        return deps.size();
+    }, entries);
+    report("nlohmann::json", ms, text.size(), entries);
+#else
+    std::cout << "  nlohmann::json not found at configure time; comparison skipped" << std::endl;
+#endif
+    return 0;
+}
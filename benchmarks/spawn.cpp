@@ -0,0 +1,70 @@
+// Spawns `true` repeatedly and reports spawns per second for the old
+// fork()-based launch (with and without the `sh -c` wrapper call sites used
+// to add) against CommandExecutor's posix_spawn path. The parent first
+// touches `ballast` MiB of heap: fork() copies the page tables for all of
+// it, posix_spawn does not.
+//
+//   spawn [iterations=500] [ballast_mib=256]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Commands.hpp"
+
+namespace {
+
+void forkExec(const std::vector<std::string>& args) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char*> argv;
+        for (const auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+}
+
+void report(const std::string& name, size_t iterations, const std::function<void()>& spawnOne) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) spawnOne();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(8) << iterations / seconds << " spawns/s" << std::setprecision(1) << std::setw(9)
+              << seconds * 1e6 / iterations << " us each" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    size_t ballastMiB = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 256;
+    std::vector<char> ballast(ballastMiB << 20);
+    std::memset(ballast.data(), 1, ballast.size());
+    std::cout << "Spawning `true` " << iterations << " times from a parent with " << ballastMiB
+              << " MiB resident" << std::endl;
+
+    report("fork + sh -c (before)", iterations, [] { forkExec({"/bin/sh", "-c", "true"}); });
+    report("fork + exec", iterations, [] { forkExec({"true"}); });
+    report("CommandExecutor::spawn", iterations, [] {
+        Harbour::CommandExecutor::Process process;
+        std::string error;
+        int stdio[3] = {-1, -1, -1};
+        if (!Harbour::CommandExecutor::spawn({"true"}, {}, stdio, process, error)) return;
+        int status;
+        waitpid(process.pid, &status, 0);
+        if (process.pidfd >= 0) close(process.pidfd);
+    });
+    report("CommandExecutor::run (after)", iterations, [] {
+        Harbour::CommandExecutor exec;
+        exec.run({"true"}, false);
+    });
+    return ballast[ballast.size() / 2] == 1 ? 0 : 1;
+}
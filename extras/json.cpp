@@ -1,46 +1,38 @@
 #include <iostream>
-#include <fstream>
-#include <nlohmann/json.hpp>
+#include <string>
+#include "Manifest.hpp"
 
-using json = nlohmann::json;
+using Harbour::Project::Manifest;
 
 int main() {
-    std::ifstream in(".hrbr");
-    if (!in) {
-        std::cerr << ".hrbr file not found!" << std::endl;
+    Manifest manifest;
+    std::string error;
+    if (!manifest.load(Manifest::FILE_NAME, error)) {
+        std::cerr << error << std::endl;
         return 1;
     }
-    json j;
-    in >> j;
 
     std::cout << "[info]" << std::endl;
-    if (j.contains("info")) {
-        auto& info = j["info"];
-        std::cout << "  name: " << info.value("name", "") << std::endl;
-        std::cout << "  type: " << info.value("type", "") << std::endl;
-        std::cout << "  version: " << info.value("version", "") << std::endl;
-    }
+    std::cout << "  name: " << manifest.name << std::endl;
+    std::cout << "  type: " << manifest.type << std::endl;
+    std::cout << "  version: " << manifest.version << std::endl;
 
     std::cout << "\n[scripts]" << std::endl;
-    if (j.contains("scripts")) {
-        for (auto& [key, val] : j["scripts"].items()) {
-            std::cout << "  " << key << ": ";
-            if (val.is_string()) {
-                std::cout << val.get<std::string>() << std::endl;
-            } else if (val.is_array()) {
-                std::cout << std::endl;
-                for (auto& cmd : val) {
-                    std::cout << "    - " << cmd.get<std::string>() << std::endl;
-                }
+    for (const auto& script : manifest.scripts) {
+        std::cout << "  " << script.name << ": ";
+        if (script.commands.size() == 1) {
+            std::cout << script.commands[0] << std::endl;
+        } else {
+            std::cout << std::endl;
+            for (const auto& cmd : script.commands) {
+                std::cout << "    - " << cmd << std::endl;
             }
         }
     }
 
     std::cout << "\n[dependencies]" << std::endl;
-    if (j.contains("dependencies")) {
-        for (auto& [dep, ver] : j["dependencies"].items()) {
-            std::cout << "  " << dep << ": " << ver.get<std::string>() << std::endl;
-        }
+    for (const auto& [dep, ver] : manifest.dependencies) {
+        std::cout << "  " << dep << ": " << ver << std::endl;
     }
     return 0;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace Harbour {
+namespace Project {
+
+// Machine-wide cache of prebuilt CMake dependencies:
+//   <name>/<key>/        install prefix (lib/, include/, lib/cmake/...)
+//   <name>/<key>.lock    held while the entry is being built
+// The key covers the C compiler, CFLAGS/LDFLAGS, the build type, the
+// dependency's revision and the CMake options it is built with, so each
+// combination is compiled once and every project links the same archive.
+class ArtifactCache {
+public:
+    // An empty dir selects defaultDir()
+    explicit ArtifactCache(const std::string& dir = "");
+
+    static std::string key(const std::string& source, const std::string& buildType,
+                           const std::vector<std::string>& cmakeArgs);
+
+    // Returns the install prefix of `source` built as `buildType`, building
+    // and installing it on a miss. Returns "" and sets error on failure.
+    std::string ensure(const std::string& name, const std::string& source, const std::string& buildType,
+                       const std::vector<std::string>& cmakeArgs, unsigned jobs, std::string& error);
+
+    // Commit recorded in <source>/.harbour-rev by the dependency store, else
+    // a hash of the source files for trees harbour did not check out
+    static std::string sourceRevision(const std::string& source);
+
+    const std::string& getDir() const { return dir; }
+
+    // $HARBOUR_ARTIFACTS, else ~/.harbour/artifacts
+    static std::string defaultDir();
+
+    static constexpr const char* REVISION_FILE = ".harbour-rev";
+
+private:
+    std::string dir;
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,64 @@
+#pragma once
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Harbour {
+namespace Project {
+
+struct BenchOptions {
+    int runs = 10;
+    int warmups = 2;
+    std::string save;              // store the samples as this baseline
+    std::string compare;           // baseline to test against; a regression fails the run
+    double threshold = 0.05;       // relative slowdown below which nothing is flagged
+    std::vector<std::string> args; // passed to the binary
+};
+
+// Whole-binary benchmarking for `harbour bench`. The newest built binary is
+// run after some warmups, each run measured through wait4(2), and the
+// samples summarized with medians rather than means so one slow run does
+// not skew the result. Baselines are kept under build/bench/.
+class Bencher {
+public:
+    struct Sample {
+        double wallMs = 0;
+        double userMs = 0;
+        double sysMs = 0;
+        double maxRssKb = 0;
+    };
+
+    struct Baseline {
+        std::string binary;
+        std::vector<Sample> samples;
+    };
+
+    struct Regression {
+        std::string metric;
+        double before = 0;  // medians
+        double after = 0;
+        double p = 1;       // chance of a slowdown this large without a real change
+    };
+
+    bool benchProject(const std::string& path, const BenchOptions& options = {});
+
+    // Runs binary once with its output discarded; false if it could not
+    // start or did not exit with 0
+    static bool measure(const std::string& binary, const std::vector<std::string>& args, Sample& sample,
+                        std::string& error);
+
+    // Wall time, CPU time (user + sys) and max RSS that got significantly
+    // (p < alpha) and noticeably (more than threshold) worse
+    static std::vector<Regression> regressions(const std::vector<Sample>& before, const std::vector<Sample>& after,
+                                               double threshold, double alpha = 0.05);
+
+    static void report(std::ostream& out, const std::vector<Sample>& samples);
+
+    // <projectPath>/build/bench/<name>.bench
+    static std::string baselinePath(const std::string& projectPath, const std::string& name);
+    static bool saveBaseline(const std::string& file, const Baseline& baseline);
+    static bool loadBaseline(const std::string& file, Baseline& baseline);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -1,13 +1,36 @@
 #pragma once
 #include <string>
+#include "ConfigManager.hpp"
 
 namespace Harbour {
 namespace Project {
 
+// Per-invocation overrides from the command line. Anything left at its
+// default falls back to .harbourConfig, then to auto-detection.
+struct BuildOptions {
+    int jobs = 0;              // 0 = build_jobs from config, else usable cores
+    std::string generator;     // "ninja", "make" or "auto"; empty = config
+    int compileCache = -1;     // -1 = compile_cache from config, 0 = off, 1 = on
+    std::string engine;        // "cmake" or "native"; empty = config
+    int unity = -1;            // -1 = unity_build from config, 0 = off, 1 = on
+    std::string traceFile;     // Chrome trace-event JSON output, empty = none
+    bool profileCompile = false;    // per-TU compile timing report
+    long long compileBudgetMs = -1; // -1 = compile_budget_ms from config, 0 = none
+    bool reuseConfiguration = false; // skip configure when the tree is already configured
+    bool verifyDependencies = false; // re-hash external/ against harbour.lock
+};
+
 class Builder {
 public:
-    bool buildProject(const std::string& path, bool debugMode, bool cleanBuild = false);
+    bool buildProject(const std::string& path, bool debugMode, bool cleanBuild = false, const BuildOptions& options = {});
+
+private:
+    bool configureWithCMake(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+                            bool debugMode, const BuildOptions& options, const std::string& generator,
+                            bool useCache);
+    bool buildWithCMake(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+                        bool debugMode, const BuildOptions& options, unsigned jobs, bool useCache);
 };
 
 } // namespace Project
-} // namespace Harbour 
\ No newline at end of file
+} // namespace Harbour
@@ -3,9 +3,16 @@
 namespace Harbour {
 namespace Project {
 
+struct BuildOptions;
+
 class CLI {
 public:
     int run(int argc, char* argv[]);
+
+    // Flags shared by `build`, `make` and `watch`. Advances i past the
+    // options and returns false after reporting an unknown or malformed one.
+    static bool parseBuildFlags(int argc, char* argv[], int& i, bool& debugMode,
+                                bool& cleanBuild, BuildOptions& options);
 };
 
 } // namespace Project
@@ -1,17 +1,157 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/types.h>
 
 
 namespace Harbour {
-// Handles secure and robust command execution
+// Handles secure and robust command execution. Commands are argv vectors
+// started with posix_spawnp; nothing goes through a shell unless the caller
+// runs one, which is only right for user-supplied script strings.
 class CommandExecutor {
 public:
+    enum class Stream { Out, Err };
+    // Receives each complete line (without the newline) as it arrives. A
+    // final line without a newline is delivered when the stream closes.
+    using LineCallback = std::function<void(Stream, std::string_view)>;
+
+    // Caps for one command; 0 leaves a resource alone. The rlimits are set in
+    // the child, so like onSpawn they need fork(). The cgroup caps put the
+    // command in a group of its own, made for its lifetime under the cgroup
+    // v2 group named by $HARBOUR_CGROUP. That group must be delegated to
+    // us and hold no processes itself; Harbour does not move itself between
+    // groups. Without a usable one the caps are skipped with a debug note
+    // and the command still runs.
+    struct Limits {
+        rlim_t cpuSeconds = 0;    // RLIMIT_CPU: SIGXCPU, then SIGKILL a second later
+        rlim_t addressSpace = 0;  // RLIMIT_AS, bytes
+        rlim_t fileSize = 0;      // RLIMIT_FSIZE, bytes
+        rlim_t openFiles = 0;     // RLIMIT_NOFILE
+        uint64_t memoryMax = 0;   // memory.max, bytes
+        double cpuMax = 0;        // cpu.max in cores, e.g. 1.5
+    };
+
+    struct Options {
+        bool capture = true;         // collect stdout/stderr into the Result
+        bool mergeStderr = false;    // send stderr down the stdout pipe, keeping the interleaving
+        LineCallback onLine;         // live line stream; implies pipes even without capture
+        size_t maxCaptureBytes = 0;  // per stream; 0 = unbounded, else only the tail is kept
+        std::string spillPath;       // when set, a stream over the cap is written in full
+                                     // to <spillPath>.stdout / <spillPath>.stderr
+        const std::atomic<bool>* cancel = nullptr;  // when it turns true, the command's
+                                                    // process group is terminated
+        // Forwarding, used when capture is off and there is no onLine. With
+        // neither field set the child simply inherits stdout/stderr.
+        std::string teePath;         // also write both streams to this file; the bytes are
+                                     // moved with splice(2)/tee(2), not through user space
+        size_t tailBytes = 0;        // keep the last tailBytes of each stream in the Result
+        // Runs in the parent once the child exists; the child waits for it
+        // to return before it execs, so anything attached here sees the exec.
+        // Needs fork(), so it costs the page-table copy posix_spawn avoids.
+        std::function<void(pid_t)> onSpawn;
+        std::string cwd;               // working directory of the command; empty = ours
+        std::vector<std::string> env;  // NAME=value entries set over our environment
+        // A command still running after timeoutMs gets SIGTERM in its whole
+        // process group, then SIGKILL killGraceMs later
+        unsigned timeoutMs = 0;        // 0 = no limit
+        unsigned killGraceMs = 500;
+        // The command shares our terminal: it stays in our process group, so
+        // it can read the tty and Ctrl-C reaches it, and a cancel or timeout
+        // signals only the command itself. Ignored by ProcessPool.
+        bool foreground = false;
+        Limits limits;
+    };
+
+    // A started child. pidfd becomes readable when it exits (-1 on kernels
+    // without pidfd_open); reap it with waitpid/wait4 on pid either way.
+    struct Process {
+        pid_t pid = -1;
+        int pidfd = -1;
+        std::string cgroup;  // the group made for Options::limits, if any
+    };
+
     struct Result {
-        int exitCode;
+        int exitCode = 0;
         std::string output;
         std::string error;
+        bool truncated = false;      // a stream exceeded maxCaptureBytes or tailBytes
+        std::string outputSpill;     // full stdout on disk, if it spilled
+        std::string errorSpill;      // full stderr on disk, if it spilled
+        bool cancelled = false;      // stopped through Options::cancel
+        bool timedOut = false;       // stopped by Options::timeoutMs
+        rusage usage{};              // the child's resource usage, from wait4(2)
+        // What the command cost. CPU, RSS and I/O include the children it
+        // reaped itself, as wait4(2) reports them.
+        double wallMs = 0;           // from spawn to exit
+        double cpuMs = 0;            // user + system
+        long maxRssKb = 0;
+        uint64_t readBytes = 0;      // through read(2) and friends, cache hits and pipes
+        uint64_t writeBytes = 0;     // included; 0 without /proc/<pid>/io
+
+        // A command that did not run or was stopped, with why in error
+        static Result failed(int exitCode, std::string error) {
+            Result result;
+            result.exitCode = exitCode;
+            result.error = std::move(error);
+            return result;
+        }
     };
     Result run(const std::vector<std::string>& args, bool captureOutput = false);
-}; 
+    Result run(const std::vector<std::string>& args, const Options& options);
+    // Captures stderr folded into Result::output, in the order it was
+    // written. Compilers print diagnostics to stderr and nothing to stdout.
+    static Result runMerged(const std::vector<std::string>& args);
+
+    // The launch under run(): args[0] is searched on PATH, stdio[i] becomes
+    // fd i in the child (-1 keeps ours), Options::cwd, env and onSpawn are
+    // applied, a cancellable command gets its own process group, and every
+    // other descriptor is closed. false with error if it could not start.
+    static bool spawn(const std::vector<std::string>& args, const Options& options, const int stdio[3],
+                      Process& process, std::string& error);
+    // Reaps a spawned child, filling status, usage and the cost fields of
+    // result except wallMs, and removes its cgroup. Blocks unless wait is
+    // false, in which case it returns false while the child still runs.
+    static bool reap(Process& process, bool wait, int& status, Result& result);
+};
+
+// Runs many commands at once, at most maxRunning at a time, from a single
+// event thread that waits on every pipe and pidfd through one epoll set.
+// Each command gets its own process group, so cancelling it also stops what
+// it spawned. Options work as in CommandExecutor::run, except that teePath
+// and tailBytes are ignored; onLine and the completion callbacks run on the
+// event thread and must not block.
+class ProcessPool {
+public:
+    using Callback = std::function<void(CommandExecutor::Result)>;
+
+    explicit ProcessPool(unsigned maxRunning = 0);  // 0 = usable cores
+    // Waits for everything submitted; call cancelAll() first to stop early
+    ~ProcessPool();
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+
+    std::future<CommandExecutor::Result> submit(std::vector<std::string> args, CommandExecutor::Options options = {});
+    void submit(std::vector<std::string> args, CommandExecutor::Options options, Callback done);
+
+    // Drops queued commands (they complete as cancelled) and terminates the
+    // process groups of running ones: SIGTERM, then SIGKILL after killGraceMs
+    void cancelAll();
+    // Blocks until every command submitted so far has completed
+    void wait();
+
+private:
+    struct Loop;
+    std::unique_ptr<Loop> loop;
+};
 
 }
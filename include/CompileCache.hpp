@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace Harbour {
+namespace Project {
+
+// Content-addressed object cache used as a CMake compiler launcher. Entries
+// are keyed on the compiler identity, the flags and the preprocessed
+// source, with the project root remapped so that hits carry across
+// checkouts. The cache is shared by every project and build type.
+class CompileCache {
+public:
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long uncacheable = 0;
+        long long compileMs = 0;   // time spent in real compiles (misses)
+        long long savedMs = 0;     // compile time avoided by hits
+        long long sizeBytes = 0;
+        long long entries = 0;
+    };
+
+    // An empty dir selects defaultDir()
+    explicit CompileCache(const std::string& dir = "");
+
+    // Compiles `compilerArgs` (compiler first) through the cache and returns
+    // the compiler's exit code. Paths under baseDir are hashed relative to it.
+    int exec(const std::string& baseDir, const std::vector<std::string>& compilerArgs);
+
+    Stats stats() const;
+    void printStats() const;
+    bool clear();
+    const std::string& getDir() const;
+
+    // $HARBOUR_CACHE_DIR, else $XDG_CACHE_HOME/harbour, else ~/.cache/harbour
+    static std::string defaultDir();
+
+    // Upper bound on stored objects; least recently used entries are evicted
+    // past it. Defaults to $HARBOUR_CACHE_MAXSIZE (K/M/G suffixes) or 5G.
+    long long maxSize;
+
+private:
+    std::string dir;
+    void saveStats(const Stats& s);
+    void updateStats(const Stats& delta);
+    void evict();
+};
+
+} // namespace Project
+} // namespace Harbour
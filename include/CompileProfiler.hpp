@@ -0,0 +1,65 @@
+#pragma once
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Harbour {
+namespace Project {
+
+// Per-translation-unit compile profiling for `build --profile-compile`.
+// Compiles go through `harbour profile exec`, which adds the compiler's
+// timing flag (-ftime-trace for clang, -ftime-report for GCC) and records
+// each TU's wall time next to its object. collect() then aggregates those
+// records and the clang traces into a report of slow TUs, headers and
+// template instantiations.
+class CompileProfiler {
+public:
+    struct Unit {
+        std::string source;
+        std::string object;
+        long long wallMs = 0;
+    };
+
+    struct Entry {
+        std::string name;
+        double ms = 0;
+        long long count = 0;
+    };
+
+    // Timing flag understood by $CXX (or c++)
+    static std::string timeFlag();
+
+    // Compiler launcher: runs compilerArgs with `flag` appended, prints the
+    // compiler's diagnostics and writes <object>.harbour-profile.
+    int exec(const std::string& flag, const std::vector<std::string>& compilerArgs);
+
+    // Drops the records of previous builds so a report only covers the TUs
+    // that were actually compiled this time.
+    static void reset(const std::string& buildPath);
+
+    // Reads every record under buildPath; false if there were none
+    bool collect(const std::string& buildPath);
+
+    void report(std::ostream& out, size_t top = 10) const;
+
+    // Units whose wall time exceeded budgetMs, slowest first
+    std::vector<Unit> overBudget(long long budgetMs) const;
+
+    const std::vector<Unit>& getUnits() const { return units; }
+    std::vector<Entry> headers() const { return ranked(headerTimes); }
+    std::vector<Entry> templates() const { return ranked(templateTimes); }
+    std::vector<Entry> phases() const { return ranked(phaseTimes); }
+
+private:
+    std::vector<Unit> units;
+    std::map<std::string, Entry> headerTimes;    // clang "Source" events, inclusive
+    std::map<std::string, Entry> templateTimes;  // clang Instantiate* events
+    std::map<std::string, Entry> phaseTimes;     // GCC -ftime-report wall times
+
+    void readTrace(const std::string& tracePath);
+    static std::vector<Entry> ranked(const std::map<std::string, Entry>& times);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -1,5 +1,7 @@
 #pragma once
+#include <map>
 #include <string>
+#include "Manifest.hpp"
 
 namespace Harbour {
 namespace Project {
@@ -9,12 +11,33 @@ public:
     bool readConfig(const std::string& path);
     bool writeConfig(const std::string& path, const std::string& projectName, int cppVersion, const std::string& runtimeBin, const std::string& runtimeLib, bool enableDebug, bool enableGraphics, const std::string& dependencies);
     std::string projectName;
-    int cppVersion;
+    int cppVersion = 17;
     std::string runtimeBin;
     std::string runtimeLib;
     bool enableDebug;
     bool enableGraphics;
     std::string dependencies;
+    // Optional keys; absent from older .harbourConfig files
+    int buildJobs = 0;
+    std::string buildGenerator = "auto";
+    bool compileCache = false;
+    std::string buildEngine = "cmake";
+    std::string precompiledHeaders;   // "auto", "off" or a list; empty = auto for graphics
+    bool unityBuild = false;
+    int unityBatchSize = 8;            // TUs per batch, 0 = unbounded
+    long long unityBatchBytes = 0;     // source bytes per batch, 0 = unbounded
+    std::string unityExclude;          // comma separated, relative to the project root
+    long long compileBudgetMs = 0;     // per-TU limit under --profile-compile, 0 = none
+    std::map<std::string, std::string> mirrors;    // mirror_<dep>: clone URL, file:// works offline
+    std::map<std::string, std::string> revisions;  // rev_<dep>: tag, branch or commit to pin
+    std::string dependencyStore;                   // empty = ~/.harbour/store
+    unsigned fetchTimeoutMs = 0;                   // stop a dependency fetch after this long, 0 = never
+    std::string packageIndex;                      // .hrbr resolver index; empty = ~/.harbour/index
+    bool hasManifest = false;                      // a .hrbr sits next to .harbourConfig
+    Manifest manifest;
+    std::string gladApi;                           // glad --api spec; empty = gl:compatibility=3.3
+    bool prebuiltDependencies = true;  // link GLFW from the artifact cache
+    std::string artifactCache;         // empty = ~/.harbour/artifacts
 };
 
 } // namespace Project
@@ -0,0 +1,57 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ConfigManager.hpp"
+#include "Watcher.hpp"
+
+namespace Harbour {
+namespace Project {
+
+// harbourd: an optional background process that keeps per-project state
+// warm between `harbour build` invocations. It caches the parsed
+// .harbourConfig, remembers that dependencies were satisfied, and watches
+// the tree with inotify so that a build with nothing to do is answered
+// without spawning cmake. Anything else runs in a forked worker that
+// writes straight to the client's terminal.
+class Daemon {
+public:
+    // $HARBOUR_DAEMON_SOCKET, else $XDG_RUNTIME_DIR/harbour/harbourd.sock,
+    // else /tmp/harbour-<uid>/harbourd.sock
+    static std::string socketPath();
+
+    // Client side: runs `harbour <args...>` in the daemon with this
+    // process's stdout/stderr. Returns false when no daemon is reachable
+    // or HARBOUR_NO_DAEMON is set, in which case the caller runs in-process.
+    static bool forward(const std::vector<std::string>& args, int& exitCode);
+
+    // Serves requests in the foreground until `daemon stop`
+    int serve();
+
+    // Forks serve() into the background; false if one is already running
+    // or it failed to come up
+    static bool start();
+
+private:
+    struct ProjectState {
+        ConfigManager cfg;
+        std::unique_ptr<Watcher> watcher;
+        std::string upToDateKey;  // request key of the last clean build, empty = dirty
+    };
+
+    std::map<std::string, ProjectState> projects;  // keyed by canonical project path
+    int listenFd = -1;
+    std::string running;  // arguments of the worker in flight, empty when idle
+
+    int handle(int client, const std::vector<std::string>& args, const std::string& cwd,
+               const std::vector<std::string>& env, int outFd, int errFd);
+    int control(const std::vector<std::string>& args, int outFd);  // daemon status / stop
+    void answerWhileBusy();
+    int runWorker(int client, const std::vector<std::string>& args, const std::string& cwd,
+                  const std::vector<std::string>& env, int outFd, int errFd);
+    ProjectState* track(const std::string& path);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -1,12 +1,36 @@
 #pragma once
+#include <map>
+#include <string>
+#include "ConfigManager.hpp"
 
 namespace Harbour {
 namespace Project {
 
 class DependencyManager {
 public:
-    bool checkDependencies(bool enableGraphics);
+    // jobs bounds how many dependencies are fetched at once; 0 picks one
+    // worker per missing dependency, up to MAX_FETCH_JOBS
+    explicit DependencyManager(unsigned jobs = 0);
+    // Takes mirror_<dep>, rev_<dep>, dependency_store, fetch_timeout_ms and
+    // glad_api from the config
+    explicit DependencyManager(const ConfigManager& cfg, unsigned jobs = 0);
+
+    // Fetches what is missing and records it in harbour.lock. Checkouts
+    // already present are checked against the lockfile's stat snapshot;
+    // verify re-hashes their contents regardless.
+    bool checkDependencies(bool enableGraphics, bool verify = false);
+
+    static constexpr unsigned MAX_FETCH_JOBS = 4;
+    static constexpr const char* DEFAULT_GLAD_API = "gl:compatibility=3.3";
+
+private:
+    unsigned jobs;
+    std::map<std::string, std::string> mirrors;    // dependency key -> clone URL
+    std::map<std::string, std::string> revisions;  // dependency key -> pinned rev
+    std::string storeDir;                          // empty = DependencyStore::defaultDir()
+    unsigned fetchTimeoutMs = 0;                   // 0 = fetches may take as long as they need
+    std::string gladApi = DEFAULT_GLAD_API;        // loader spec passed to glad --api
 };
 
 } // namespace Project
-} // namespace Harbour 
\ No newline at end of file
+} // namespace Harbour 
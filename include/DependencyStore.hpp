@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+namespace Harbour {
+namespace Project {
+
+// Machine-wide store of dependency sources shared by every project:
+//   mirrors/<name>-<url hash>.git   bare repos holding only the pinned revs
+//   trees/<commit>/                 read-only extracted checkouts
+//   generated/<name>-<inputs hash>/ read-only generator output
+// Projects get their external/<dep> as a reflink or hardlink copy of a tree,
+// so N projects on the same revision cost one checkout's worth of disk, and
+// once a revision is in the store no network access is needed.
+class DependencyStore {
+public:
+    // An empty dir selects defaultDir(); a fetch still running after
+    // fetchTimeoutMs is stopped and fails, 0 lets it run
+    explicit DependencyStore(const std::string& dir = "", unsigned fetchTimeoutMs = 0);
+
+    // Makes sure `rev` of `url` is in the store, fetching it shallowly if
+    // needed, and returns its tree directory. Returns "" and sets error on
+    // failure; `cancel` aborts a fetch in flight.
+    std::string resolve(const std::string& name, const std::string& url, const std::string& rev,
+                        const std::atomic<bool>* cancel, std::string& error);
+
+    // Copies a store tree to dest, preferring reflinks, then hardlinks, then
+    // a plain copy when the store is on another filesystem.
+    static bool materialize(const std::string& tree, const std::string& dest, std::string& error);
+
+    // Output of a generator run over a store tree, such as the GLAD loader,
+    // keyed on everything that determines it. generated() returns the cached
+    // directory or "" on a miss; storeGenerated() copies `output` in.
+    std::string generated(const std::string& name, const std::string& inputs) const;
+    std::string storeGenerated(const std::string& name, const std::string& inputs, const std::string& output,
+                               std::string& error);
+
+    const std::string& getDir() const { return dir; }
+
+    // $HARBOUR_STORE, else ~/.harbour/store
+    static std::string defaultDir();
+
+private:
+    std::string dir;
+    unsigned fetchTimeoutMs;
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,42 @@
+#pragma once
+#include <map>
+#include <string>
+
+namespace Harbour {
+namespace Project {
+
+// harbour.lock in the project root: what each dependency under external/
+// was resolved to, a hash of its contents, and a stat snapshot of its tree.
+// The snapshot lets every build confirm a checkout is intact with lstat()
+// calls alone; contents are only re-hashed when the snapshot moves.
+class Lockfile {
+public:
+    struct Entry {
+        std::string url;
+        std::string rev;       // as requested: tag, branch or commit
+        std::string commit;    // what rev resolved to
+        std::string hash;      // treeHash() of the checkout
+        std::string snapshot;  // statSnapshot() of the checkout
+    };
+
+    // A missing file reads as an empty lockfile
+    bool read(const std::string& path);
+    bool write(const std::string& path) const;
+
+    const Entry* find(const std::string& name) const;
+    void set(const std::string& name, const Entry& entry) { entries[name] = entry; }
+    const std::map<std::string, Entry>& getEntries() const { return entries; }
+
+    // Paths, file modes and contents of every file and symlink in the tree
+    static std::string treeHash(const std::string& dir);
+    // Paths, mtimes, inodes, sizes and modes of every entry in the tree
+    static std::string statSnapshot(const std::string& dir);
+
+    static constexpr const char* FILE_NAME = "harbour.lock";
+
+private:
+    std::map<std::string, Entry> entries;
+};
+
+} // namespace Project
+} // namespace Harbour
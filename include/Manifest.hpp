@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Harbour {
+namespace Project {
+
+// Typed view of a .hrbr manifest:
+//   {"info": {"name": ..., "type": ..., "version": ...},
+//    "scripts": {"<name>": "<command>" or ["<command>", ...]},
+//    "dependencies": {"<package>": "<semver range>"}}
+// Parsed with Harbour::Json, which slices the text instead of copying it;
+// only the fields kept here are decoded into strings.
+class Manifest {
+public:
+    struct Script {
+        std::string name;
+        std::vector<std::string> commands;
+    };
+
+    bool load(const std::string& path, std::string& error);
+    bool parse(std::string_view text, std::string& error);
+
+    // nullptr when the manifest does not define it
+    const Script* script(const std::string& name) const;
+
+    std::string name;
+    std::string type;
+    std::string version;
+    std::vector<Script> scripts;                                    // document order
+    std::vector<std::pair<std::string, std::string>> dependencies;  // package -> range, document order
+
+    static constexpr const char* FILE_NAME = ".hrbr";
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include "ConfigManager.hpp"
+
+namespace Harbour {
+namespace Project {
+
+// Built-in incremental engine for the single-executable layout that
+// ProjectCreator scaffolds (src/ + include/). Compiles stale translation
+// units in parallel and links, without going through CMake.
+class NativeBuilder {
+public:
+    // False when the project needs CMake: graphics dependencies, or a
+    // CMakeLists.txt that declares more than the scaffolded executable.
+    static bool supports(const std::string& path, const ConfigManager& cfg);
+
+    bool build(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+               bool debugMode, unsigned jobs, bool useCache);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,75 @@
+#pragma once
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+namespace Harbour {
+namespace Project {
+
+// Counters for `harbour run --perf`, read through perf_event_open(2). They
+// are attached to the child between fork and exec and enabled by the exec,
+// so only the program itself is counted, including the threads and
+// processes it starts. Hardware events come in small groups (cycles with
+// instructions, accesses with misses) so each ratio is measured over the
+// same interval. Where the PMU is not exposed, as in many containers, only
+// the software events are used.
+class PerfCounters {
+public:
+    // event name -> count, scaled up if the kernel had to multiplex it
+    using Counts = std::map<std::string, double>;
+
+    struct Thread {
+        pid_t tid = 0;
+        std::string name;
+        Counts counts;
+    };
+
+    explicit PerfCounters(bool perThread = false);
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // pid must not have exec'd yet. False when no counter could be opened.
+    bool attach(pid_t pid);
+    // Per-thread mode: starts counting threads created since the last call
+    void poll();
+    // Reads the final counts once the program has exited
+    void collect();
+
+    bool hardware() const { return hasHardware; }
+    const Counts& totals() const { return counts; }
+    const std::vector<Thread>& threads() const { return threadCounts; }
+
+    // IPC and miss rates, for whichever inputs were counted
+    static Counts derived(const Counts& counts);
+
+    void report(std::ostream& out) const;
+    // One name=value line per count, in a fixed order so runs diff cleanly
+    bool write(const std::string& file) const;
+
+private:
+    struct Counter {
+        std::string name;
+        int fd = -1;
+    };
+    struct Watched {
+        pid_t tid;
+        std::vector<Counter> counters;
+    };
+
+    bool perThread;
+    bool hasHardware = false;
+    pid_t pid = -1;
+    std::vector<Counter> process;   // inherit: the whole process tree
+    std::vector<Watched> watched;   // per-thread mode only
+    Counts counts;
+    std::vector<Thread> threadCounts;
+
+    std::vector<Counter> open(pid_t target, bool inherit, bool onExec, bool& hardwareOpened);
+    static Counts read(const std::vector<Counter>& counters);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,76 @@
+#pragma once
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "semver.hpp"
+
+namespace Harbour {
+namespace Project {
+
+// Resolves the semver ranges in a .hrbr manifest to one version per
+// package, following transitive dependencies, against a local index: a
+// directory with one <name>.json descriptor per package, e.g.
+//   {"versions": {"1.11.0": {"url": "https://github.com/gabime/spdlog.git",
+//                            "rev": "v1.11.0",
+//                            "dependencies": {"fmt": "^9.1.0"}}}}
+// The newest matching version is tried first, backtracking on conflicts.
+class Resolver {
+public:
+    using Requirements = std::vector<std::pair<std::string, std::string>>;  // name -> range
+
+    struct Package {
+        std::string name;
+        std::string version;
+        std::string url;
+        std::string rev;
+        std::vector<std::string> dependencies;  // names of the packages it pulls in
+    };
+
+    // An empty dir selects defaultIndex()
+    explicit Resolver(const std::string& indexDir = "");
+
+    // Fills `packages` sorted by name, or returns false with the conflict in error
+    bool resolve(const Requirements& requirements, std::vector<Package>& packages, std::string& error);
+
+    // Like resolve(), but reuses lockPath when it was written for exactly
+    // these requirements, so repeat builds never open the index. Otherwise
+    // resolves and rewrites it. fromLock reports which happened.
+    bool resolveLocked(const Requirements& requirements, const std::string& lockPath, std::vector<Package>& packages,
+                       std::string& error, bool* fromLock = nullptr);
+
+    // Manifest::dependencies of the .hrbr at path
+    static bool readManifest(const std::string& path, Requirements& requirements, std::string& error);
+
+    // $HARBOUR_INDEX, else ~/.harbour/index
+    static std::string defaultIndex();
+
+    static constexpr const char* LOCK_FILE = "hrbr.lock";
+
+private:
+    struct Release {
+        Semver::Version version;
+        std::string url;
+        std::string rev;
+        Requirements dependencies;
+    };
+    struct Pending {
+        std::string name;
+        std::string range;
+        std::string requiredBy;
+    };
+
+    std::string indexDir;
+    // Memoized per resolver: parsed descriptors (newest release first) and
+    // the releases matching each (package, range) pair
+    std::map<std::string, std::vector<Release>> descriptors;
+    std::map<std::pair<std::string, std::string>, std::vector<const Release*>> candidates;
+
+    const std::vector<Release>* releases(const std::string& name, std::string& error);
+    const std::vector<const Release*>* matching(const std::string& name, const std::string& range, std::string& error);
+    bool solve(std::vector<Pending> queue, size_t next, std::map<std::string, const Release*>& chosen,
+               std::string& error);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -1,12 +1,29 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 namespace Harbour {
 namespace Project {
 
+struct RunOptions {
+    std::string logFile;      // also write the program's output here
+    bool perf = false;        // count the run with perf_event_open
+    bool perfThreads = false; // break the counts down per thread
+    std::string perfOutput;   // write the counts as name=value lines
+    unsigned timeoutMs = 0;   // stop the program after this long, 0 = never
+};
+
 class Runner {
 public:
-    bool runProject(const std::string& path);
+    // The program inherits the terminal. With a logFile its output is also
+    // written there, and a failed run reports the tail of its stderr.
+    bool runProject(const std::string& path, const RunOptions& options = {});
+
+    // The newer of the debug and release binaries, or "" if neither is built
+    static std::string newestBinary(const std::string& path, const std::string& projectName);
+
+    // How much of each stream a logged run keeps for the failure report
+    static constexpr size_t FAILURE_TAIL_BYTES = 4096;
 };
 
 } // namespace Project
@@ -0,0 +1,48 @@
+#pragma once
+#include <map>
+#include <string>
+#include "Builder.hpp"
+
+namespace Harbour {
+namespace Project {
+
+// `harbour watch`: rebuilds (and optionally reruns) a project whenever
+// src/, include/, CMakeLists.txt or .harbourConfig change. Builds run in a
+// child process group so that a new burst of changes can cancel them.
+class Watcher {
+public:
+    enum class Change { None, Sources, Config };
+
+    Watcher(std::string path, bool debugMode, BuildOptions options, bool rerun, int debounceMs = 200);
+    ~Watcher();
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+
+    // Sets up the inotify watches; false if inotify is unavailable
+    bool start();
+
+    // Waits up to timeoutMs (-1 = forever) for a change, then keeps
+    // collecting until the tree has been quiet for the debounce interval.
+    // Config wins over Sources when a burst touches both.
+    Change waitForChanges(int timeoutMs);
+
+    // Builds, then loops on changes until interrupted; returns the exit code
+    int run();
+
+private:
+    std::string path;
+    bool debugMode;
+    BuildOptions options;
+    bool rerun;
+    int debounceMs;
+    int fd = -1;
+    int rootWd = -1;
+    std::map<int, std::string> dirs;  // watch descriptor -> watched directory
+
+    void watchTree(const std::string& dir);
+    Change drain();
+    int spawnBuild(Change change);
+};
+
+} // namespace Project
+} // namespace Harbour
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <ios>
@@ -22,6 +23,14 @@ private:
   std::fstream file;
   std::filesystem::path filePath;
   std::vector<Harbour::FH::FILE_MODE> modes;
+  // Where each line starts, plus the end of the file after the last line.
+  // Built by the first jumpToLine, dropped by writes, and rebuilt when the
+  // file's size or mtime no longer match what was indexed.
+  std::vector<size_t> lineStarts;
+  bool indexed = false;
+  std::uintmax_t indexedSize = 0;
+  std::filesystem::file_time_type indexedTime;
+  void ensureIndex();
 
 public:
   fileHandler(const std::filesystem::path &path, const std::string &modeStr);
@@ -30,11 +39,34 @@ public:
   void close();
   void writeLines(const std::vector<std::string> &lines);
   void seekToByte(size_t offset);
-  void jumpToLine(size_t lineNumber);
+  void jumpToLine(size_t lineNumber);  // 1-based; a seek once the file is indexed
+  size_t lineCount();                  // a final line without '\n' counts
   void jumpToEnd();
   std::fstream &getStream();
   const std::filesystem::path &getPath() const;
 };
 
+// Holds an exclusive flock(2) on path, created if missing, for its
+// lifetime. Serializes work on one shared store entry across processes.
+class FileLock {
+  int fd;
+
+public:
+  explicit FileLock(const std::filesystem::path &path);
+  ~FileLock();
+  FileLock(const FileLock &) = delete;
+  FileLock &operator=(const FileLock &) = delete;
+};
+
+// A scratch name beside path, unique to this process and thread, so that
+// publishing it is a rename within one directory.
+std::filesystem::path tempSibling(const std::filesystem::path &path);
+
+// Renames a finished tmp (file or tree) onto path, so readers find path
+// either absent or complete. A directory already at path means another
+// process published first; tmp is dropped and that counts as success. On
+// any other failure tmp is removed and ec says why.
+bool publish(const std::filesystem::path &tmp, const std::filesystem::path &path, std::error_code &ec);
+
 } // namespace FH
 } // namespace Harbour
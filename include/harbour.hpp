@@ -1,12 +1,24 @@
 #pragma once
 
+#include "ArtifactCache.hpp"
+#include "Bencher.hpp"
 #include "Builder.hpp"
 #include "CLI.hpp"
 #include "colors.hpp"
 #include "Commands.hpp"
+#include "CompileCache.hpp"
+#include "CompileProfiler.hpp"
 #include "ConfigManager.hpp"
+#include "Daemon.hpp"
 #include "DependencyManager.hpp"
+#include "DependencyStore.hpp"
+#include "Lockfile.hpp"
+#include "Manifest.hpp"
+#include "NativeBuilder.hpp"
+#include "PerfCounters.hpp"
 #include "Runner.hpp"
 #include "ProjectCreator.hpp"
+#include "Resolver.hpp"
+#include "Watcher.hpp"
 #include "files.hpp"
 #include "debug.hpp"
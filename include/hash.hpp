@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace Harbour {
+namespace Hash {
+
+// Incremental 128-bit FNV-1a. Not cryptographic; used for cache keys and
+// change detection where inputs are trusted.
+class Hasher {
+private:
+  unsigned __int128 state;
+  void mix(const char *data, size_t size);
+
+public:
+  Hasher();
+  // Each call hashes the length first, so update("ab").update("c") and
+  // update("a").update("bc") differ.
+  Hasher &update(std::string_view data);
+  Hasher &update(long long value);
+  // Hashes the file contents; returns false if it could not be read.
+  bool updateFile(const std::filesystem::path &path);
+  std::string hex() const;
+};
+
+std::string ofString(std::string_view data);
+
+} // namespace Hash
+} // namespace Harbour
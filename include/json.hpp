@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Harbour {
+namespace Json {
+
+enum class Type { Null, Bool, Number, String, Array, Object };
+
+// Parsed JSON value. Strings and keys are views into the parsed text with
+// escapes left in place (use str() to decode), so the text must outlive
+// the value.
+class Value {
+public:
+  Type type = Type::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string_view raw;                                   // String: body between the quotes
+  std::vector<Value> items;                               // Array
+  std::vector<std::pair<std::string_view, Value>> members; // Object, in document order
+
+  bool isNull() const { return type == Type::Null; }
+  bool isString() const { return type == Type::String; }
+  bool isNumber() const { return type == Type::Number; }
+  bool isArray() const { return type == Type::Array; }
+  bool isObject() const { return type == Type::Object; }
+
+  // Member lookup on objects; nullptr when absent or not an object
+  const Value *find(std::string_view key) const;
+  // Decoded string value; empty for non-strings
+  std::string str() const;
+  // Decoded member string, or fallback when missing or not a string
+  std::string get(std::string_view key, const std::string &fallback = "") const;
+};
+
+// Parses a complete document. On failure returns false and, if given,
+// fills error with a message that includes the byte offset.
+bool parse(std::string_view text, Value &out, std::string *error = nullptr);
+
+// Decodes a raw string body (\n, \", \uXXXX including surrogate pairs).
+std::string unescape(std::string_view raw);
+
+} // namespace Json
+} // namespace Harbour
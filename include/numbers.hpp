@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string_view>
+
+namespace Harbour {
+namespace Numbers {
+
+// Parse the whole of text as a base-10 number within [min, max]. Empty
+// input, signs where min >= 0 disallows them, trailing characters and
+// overflow all fail instead of throwing or wrapping around.
+bool parseInteger(std::string_view text, long long min, long long max, long long &out);
+bool parseDecimal(std::string_view text, double min, double max, double &out);
+
+} // namespace Numbers
+} // namespace Harbour
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Harbour {
+namespace Semver {
+
+// MAJOR.MINOR.PATCH[-PRERELEASE][+BUILD]; build metadata is dropped.
+struct Version {
+  long major = 0, minor = 0, patch = 0;
+  std::string prerelease;
+
+  std::string str() const;
+  // Semver 2.0 precedence, prerelease identifiers included
+  int compare(const Version &other) const;
+  bool operator<(const Version &other) const { return compare(other) < 0; }
+  bool operator==(const Version &other) const { return compare(other) == 0; }
+};
+
+bool parseVersion(std::string_view text, Version &out);
+
+// npm-style range: comparator sets joined by "||", each a space-separated
+// list of ^1.2.3, ~1.2, >=1.0.0, <2, =1.2.3, 1.2.x or *. Carets and tildes
+// are lowered to >=/< pairs on parse. Prereleases only match a set that
+// names a prerelease of the same MAJOR.MINOR.PATCH.
+class Range {
+public:
+  bool satisfies(const Version &version) const;
+  const std::string &str() const { return text; }
+
+private:
+  enum class Op { Eq, Lt, Le, Gt, Ge };
+  struct Comparator {
+    Op op;
+    Version version;
+  };
+  std::string text;
+  std::vector<std::vector<Comparator>> sets;
+
+  friend bool parseRange(std::string_view text, Range &out);
+};
+
+bool parseRange(std::string_view text, Range &out);
+
+} // namespace Semver
+} // namespace Harbour
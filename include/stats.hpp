@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+namespace Harbour {
+namespace Stats {
+
+// Robust summaries for benchmark samples. None of these assume the samples
+// are normally distributed; run times rarely are.
+double median(std::vector<double> samples);
+
+// Median absolute deviation from the median (unscaled)
+double mad(const std::vector<double> &samples);
+
+// Distribution-free confidence interval for the median, from the order
+// statistics whose ranks bracket n/2 at the given two-sided z (1.96 = 95%).
+// With few samples it widens to the full range.
+struct Interval {
+  double low = 0, high = 0;
+};
+Interval medianInterval(std::vector<double> samples, double z = 1.96);
+
+// One-sided Mann-Whitney U test: the probability of seeing `after` rank this
+// far above `before` if both came from the same distribution. Normal
+// approximation with tie correction; 1 when there is nothing to compare.
+double probabilityGreater(const std::vector<double> &before, const std::vector<double> &after);
+
+} // namespace Stats
+} // namespace Harbour
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+namespace Harbour {
+namespace Sys {
+
+// Number of CPUs this process may actually run on: the affinity mask,
+// clamped by any cgroup (v2 or v1) CPU quota. Always at least 1.
+unsigned usableCores();
+
+// Directory of our own group in the cgroup v2 hierarchy, also found on
+// hybrid hosts where it is mounted at /sys/fs/cgroup/unified. Empty when
+// there is none.
+std::string cgroupDir();
+
+// Absolute path of an executable found on PATH, or an empty string.
+std::string findProgram(const std::string &name);
+
+} // namespace Sys
+} // namespace Harbour
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Harbour {
+namespace Trace {
+
+struct Event {
+  std::string name;
+  std::string category;
+  long long startUs;      // since the recorder was created
+  long long durationUs;
+  unsigned tid;
+  std::vector<std::pair<std::string, double>> args;  // shown under "args" in trace viewers
+};
+
+// Process-wide collector of timed spans, measured on the steady clock.
+class Recorder {
+private:
+  mutable std::mutex mtx;
+  std::vector<Event> recorded;
+  std::chrono::steady_clock::time_point origin;
+  Recorder();
+
+public:
+  static Recorder &instance();
+  long long nowUs() const;
+  void record(Event event);
+  std::vector<Event> events() const;
+  void clear();
+  // Chrome trace-event JSON, loadable in Perfetto or chrome://tracing
+  bool writeChromeTrace(const std::filesystem::path &path) const;
+  // Per-event durations for one category, then a total per category
+  void printSummary(std::ostream &out, const std::string &category) const;
+};
+
+// Records the lifetime of the object as one complete ("X") event.
+class Scope {
+private:
+  std::string name;
+  std::string category;
+  long long start;
+  std::vector<std::pair<std::string, double>> args;
+
+public:
+  Scope(std::string name, std::string category);
+  // Attaches a number to the event, such as what a command cost
+  void arg(std::string key, double value);
+  ~Scope();
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+};
+
+} // namespace Trace
+} // namespace Harbour
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "harbour.hpp"
+#include "hash.hpp"
+#include "sysinfo.hpp"
+#include "trace.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Canonical path and --version banner of the C compiler CMake will pick
+std::string compilerIdentity() {
+    const char* cc = std::getenv("CC");
+    std::string compiler = Sys::findProgram(cc ? cc : "cc");
+    if (compiler.empty()) return cc ? cc : "";
+    std::error_code ec;
+    compiler = fs::canonical(compiler, ec).string();
+    CommandExecutor exec;
+    auto version = exec.run({compiler, "--version"}, true);
+    return compiler + "\n" + version.output.substr(0, version.output.find('\n'));
+}
+
+bool step(const std::vector<std::string>& args, std::string& error) {
+    std::string cmd;
+    for (const auto& arg : args) cmd += (cmd.empty() ? "" : " ") + arg;
+    debug::print(cmd);
+    CommandExecutor::Options options;
+    options.onLine = [](CommandExecutor::Stream, std::string_view line) { debug::print(line); };
+    CommandExecutor exec;
+    auto result = exec.run(args, options);
+    if (result.exitCode == 0) return true;
+    error = result.error.empty() ? result.output : result.error;
+    return false;
+}
+
+} // namespace
+
+ArtifactCache::ArtifactCache(const std::string& dir) : dir(dir.empty() ? defaultDir() : dir) {}
+
+std::string ArtifactCache::defaultDir() {
+    if (const char* artifacts = std::getenv("HARBOUR_ARTIFACTS")) return artifacts;
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.harbour/artifacts";
+    return "/tmp/harbour-artifacts";
+}
+
+std::string ArtifactCache::sourceRevision(const std::string& source) {
+    std::ifstream stamp(fs::path(source) / REVISION_FILE);
+    std::string revision;
+    if (std::getline(stamp, revision) && !revision.empty()) return revision;
+
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(source, ec))
+        if (entry.is_regular_file(ec) && entry.path().string().find("/.git/") == std::string::npos)
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+    Hash::Hasher hasher;
+    for (const auto& file : files) {
+        hasher.update(file.lexically_relative(source).string());
+        hasher.updateFile(file);
+    }
+    return hasher.hex();
+}
+
+std::string ArtifactCache::key(const std::string& source, const std::string& buildType,
+                               const std::vector<std::string>& cmakeArgs) {
+    Hash::Hasher hasher;
+    hasher.update(compilerIdentity());
+    for (const char* var : {"CFLAGS", "CPPFLAGS", "LDFLAGS", "CMAKE_GENERATOR", "CMAKE_TOOLCHAIN_FILE"}) {
+        const char* value = std::getenv(var);
+        hasher.update(value ? value : "");
+    }
+    hasher.update(buildType);
+    hasher.update(sourceRevision(source));
+    for (const auto& arg : cmakeArgs) hasher.update(arg);
+    return hasher.hex().substr(0, 16);
+}
+
+std::string ArtifactCache::ensure(const std::string& name, const std::string& source, const std::string& buildType,
+                                  const std::vector<std::string>& cmakeArgs, unsigned jobs, std::string& error) {
+    std::error_code ec;
+    fs::path entry = fs::absolute(fs::path(dir) / name / key(source, buildType, cmakeArgs));
+    if (fs::exists(entry)) return entry.string();
+
+    fs::create_directories(entry.parent_path(), ec);
+    // Serializes builds of one entry across harbour processes
+    FH::FileLock lock(entry.string() + ".lock");
+    if (fs::exists(entry)) return entry.string();  // built by another process while we waited
+
+    Trace::Scope scope("Prebuild " + name, "dependency");
+    std::cout << COLOR_YELLOW << "Building " << name << " (" << buildType << ") into the artifact cache..."
+              << COLOR_RESET << std::endl;
+    // Build and install beside the entry, then publish the prefix. CMake's
+    // exported config files are relative to the prefix, so the move is safe.
+    fs::path tmp = FH::tempSibling(entry);
+    fs::path build = tmp / "build", prefix = tmp / "prefix";
+    std::vector<std::string> configure = {"cmake", "-S", fs::absolute(source).string(), "-B", build.string(),
+                                          "-DCMAKE_BUILD_TYPE=" + buildType,
+                                          "-DCMAKE_INSTALL_PREFIX=" + prefix.string(),
+                                          "-DBUILD_SHARED_LIBS=OFF"};
+    configure.insert(configure.end(), cmakeArgs.begin(), cmakeArgs.end());
+    bool ok = step(configure, error) &&
+              step({"cmake", "--build", build.string(), "--parallel", std::to_string(std::max(jobs, 1u))}, error) &&
+              step({"cmake", "--install", build.string()}, error);
+    if (ok && !FH::publish(prefix, entry, ec)) {
+        error = ec.message();
+        ok = false;
+    }
+    fs::remove_all(tmp, ec);
+    return ok ? entry.string() : "";
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,225 @@
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "harbour.hpp"
+#include "stats.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<double> column(const std::vector<Bencher::Sample>& samples, double (*get)(const Bencher::Sample&)) {
+    std::vector<double> values;
+    values.reserve(samples.size());
+    for (const auto& s : samples) values.push_back(get(s));
+    return values;
+}
+
+struct Metric {
+    const char* name;
+    double (*get)(const Bencher::Sample&);
+};
+
+// Rows of the report; the last three are what --compare checks
+const Metric REPORTED[] = {
+    {"user ms", [](const Bencher::Sample& s) { return s.userMs; }},
+    {"sys ms", [](const Bencher::Sample& s) { return s.sysMs; }},
+    {"wall ms", [](const Bencher::Sample& s) { return s.wallMs; }},
+    {"cpu ms", [](const Bencher::Sample& s) { return s.userMs + s.sysMs; }},
+    {"max rss KiB", [](const Bencher::Sample& s) { return s.maxRssKb; }},
+};
+const size_t FIRST_COMPARED = 2;
+
+double toMs(const timeval& tv) { return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0; }
+
+} // namespace
+
+bool Bencher::measure(const std::string& binary, const std::vector<std::string>& args, Sample& sample,
+                      std::string& error) {
+    std::vector<std::string> argv = {binary};
+    argv.insert(argv.end(), args.begin(), args.end());
+    // Terminal output would be timed too; the program runs silently
+    int devNull = open("/dev/null", O_RDWR | O_CLOEXEC);
+    int stdio[3] = {devNull, devNull, devNull};
+    CommandExecutor::Process process;
+    auto start = std::chrono::steady_clock::now();
+    bool started = CommandExecutor::spawn(argv, {}, stdio, process, error);
+    if (devNull >= 0) close(devNull);
+    if (!started) return false;
+    if (process.pidfd >= 0) close(process.pidfd);
+    pid_t pid = process.pid;
+    int status = 0;
+    rusage usage{};
+    while (wait4(pid, &status, 0, &usage) < 0) {
+        if (errno != EINTR) {
+            error = "wait4() failed";
+            return false;
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        error = binary + (WIFEXITED(status) ? " exited with code " + std::to_string(WEXITSTATUS(status))
+                                            : " was killed by signal " + std::to_string(WTERMSIG(status)));
+        return false;
+    }
+    sample.wallMs = std::chrono::duration<double, std::milli>(elapsed).count();
+    sample.userMs = toMs(usage.ru_utime);
+    sample.sysMs = toMs(usage.ru_stime);
+    sample.maxRssKb = static_cast<double>(usage.ru_maxrss);
+    return true;
+}
+
+std::vector<Bencher::Regression> Bencher::regressions(const std::vector<Sample>& before,
+                                                      const std::vector<Sample>& after, double threshold,
+                                                      double alpha) {
+    std::vector<Regression> found;
+    for (size_t i = FIRST_COMPARED; i < std::size(REPORTED); ++i) {
+        auto a = column(before, REPORTED[i].get), b = column(after, REPORTED[i].get);
+        Regression r{REPORTED[i].name, Stats::median(a), Stats::median(b), Stats::probabilityGreater(a, b)};
+        if (r.p < alpha && r.after > r.before * (1 + threshold)) found.push_back(r);
+    }
+    return found;
+}
+
+void Bencher::report(std::ostream& out, const std::vector<Sample>& samples) {
+    out << std::fixed << std::setprecision(3);
+    out << "  " << std::left << std::setw(14) << "metric" << std::right << std::setw(12) << "median"
+        << std::setw(12) << "MAD" << "   95% CI of the median\n";
+    for (const auto& metric : REPORTED) {
+        auto values = column(samples, metric.get);
+        auto ci = Stats::medianInterval(values);
+        out << "  " << std::left << std::setw(14) << metric.name << std::right << std::setw(12)
+            << Stats::median(values) << std::setw(12) << Stats::mad(values) << "   [" << ci.low << ", " << ci.high
+            << "]\n";
+    }
+    out << std::defaultfloat;
+}
+
+std::string Bencher::baselinePath(const std::string& projectPath, const std::string& name) {
+    return (fs::path(projectPath) / "build" / "bench" / (name + ".bench")).string();
+}
+
+bool Bencher::saveBaseline(const std::string& file, const Baseline& baseline) {
+    std::error_code ec;
+    fs::create_directories(fs::path(file).parent_path(), ec);
+    // Written aside and renamed so an interrupted run keeps the old baseline
+    std::string tmp = file + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return false;
+        out << "# Generated by harbour bench; sample=wall_ms,user_ms,sys_ms,max_rss_kb\n";
+        out << "binary=" << baseline.binary << "\n";
+        out << std::setprecision(17);
+        for (const auto& s : baseline.samples)
+            out << "sample=" << s.wallMs << "," << s.userMs << "," << s.sysMs << "," << s.maxRssKb << "\n";
+        if (!out) return false;
+    }
+    fs::rename(tmp, file, ec);
+    return !ec;
+}
+
+bool Bencher::loadBaseline(const std::string& file, Baseline& baseline) {
+    std::ifstream in(file);
+    if (!in) return false;
+    baseline = Baseline();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("binary=", 0) == 0) {
+            baseline.binary = line.substr(7);
+        } else if (line.rfind("sample=", 0) == 0) {
+            Sample s;
+            if (std::sscanf(line.c_str() + 7, "%lf,%lf,%lf,%lf", &s.wallMs, &s.userMs, &s.sysMs, &s.maxRssKb) == 4)
+                baseline.samples.push_back(s);
+        }
+    }
+    return !baseline.samples.empty();
+}
+
+bool Bencher::benchProject(const std::string& path, const BenchOptions& options) {
+    ConfigManager cfg;
+    if (!cfg.readConfig(path)) return false;
+    std::string binary = Runner::newestBinary(path, cfg.projectName);
+    if (binary.empty()) {
+        std::cerr << COLOR_RED << "No built binary found. Build the project first." << COLOR_RESET << std::endl;
+        return false;
+    }
+    if (options.runs < 2) {
+        std::cerr << COLOR_RED << "bench needs at least 2 runs" << COLOR_RESET << std::endl;
+        return false;
+    }
+    Baseline previous;
+    std::string comparePath = options.compare.empty() ? "" : baselinePath(path, options.compare);
+    if (!comparePath.empty() && !loadBaseline(comparePath, previous)) {
+        std::cerr << COLOR_RED << "No baseline named " << options.compare << " (" << comparePath << ")"
+                  << COLOR_RESET << std::endl;
+        return false;
+    }
+
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_YELLOW << "Benchmarking " << binary << " (" << options.runs << " runs, " << options.warmups
+              << " warmups)" << COLOR_RESET << std::endl;
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    Baseline current{binary, {}};
+    std::string error;
+    for (int i = 0; i < options.warmups + options.runs; ++i) {
+        Sample sample;
+        if (!measure(binary, options.args, sample, error)) {
+            std::cerr << COLOR_RED << "Benchmark run failed: " << error << COLOR_RESET << std::endl;
+            return false;
+        }
+        if (i >= options.warmups) current.samples.push_back(sample);
+    }
+    report(std::cout, current.samples);
+
+    if (!options.save.empty()) {
+        std::string savePath = baselinePath(path, options.save);
+        if (!saveBaseline(savePath, current)) {
+            std::cerr << COLOR_RED << "Cannot write " << savePath << COLOR_RESET << std::endl;
+            return false;
+        }
+        std::cout << COLOR_GREEN << "Saved baseline " << options.save << " (" << savePath << ")" << COLOR_RESET
+                  << std::endl;
+    }
+    if (comparePath.empty()) return true;
+
+    if (previous.binary != binary)
+        std::cout << COLOR_YELLOW << "Baseline " << options.compare << " was taken with " << previous.binary
+                  << COLOR_RESET << std::endl;
+    std::cout << "Against " << options.compare << " (" << previous.samples.size() << " runs):" << std::endl;
+    auto found = regressions(previous.samples, current.samples, options.threshold);
+    for (size_t i = FIRST_COMPARED; i < std::size(REPORTED); ++i) {
+        auto a = column(previous.samples, REPORTED[i].get), b = column(current.samples, REPORTED[i].get);
+        double before = Stats::median(a), after = Stats::median(b), p = Stats::probabilityGreater(a, b);
+        bool regressed = false;
+        for (const auto& r : found) regressed |= r.metric == REPORTED[i].name;
+        double change = before > 0 ? (after - before) / before * 100 : 0;
+        std::cout << (regressed ? COLOR_RED : "") << "  " << std::left << std::setw(14) << REPORTED[i].name
+                  << std::right << std::fixed << std::setprecision(3) << before << " -> " << after << " ("
+                  << std::showpos << std::setprecision(1) << change << "%" << std::noshowpos
+                  << ", p=" << std::setprecision(3) << p << ")"
+                  << (regressed ? " REGRESSION" : "") << std::defaultfloat << (regressed ? COLOR_RESET : "")
+                  << std::endl;
+    }
+    if (!found.empty()) {
+        std::cerr << COLOR_RED << found.size() << " metric(s) regressed against " << options.compare << COLOR_RESET
+                  << std::endl;
+        return false;
+    }
+    std::cout << COLOR_GREEN << "No significant regressions." << COLOR_RESET << std::endl;
+    return true;
+}
+
+} // namespace Project
+} // namespace Harbour
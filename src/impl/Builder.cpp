@@ -1,67 +1,414 @@
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
 #include "harbour.hpp"
+#include "hash.hpp"
+#include "sysinfo.hpp"
+#include "trace.hpp"
 
 namespace Harbour {
 namespace Project {
 
-bool Builder::buildProject(const std::string& path, bool debugMode, bool cleanBuild) {
+namespace {
+
+// Maps a harbour generator name to the CMake generator, picking Ninja
+// for "auto" when it is on PATH. Returns an empty string if unusable.
+std::string resolveGenerator(const std::string& requested) {
+    if (requested == "ninja") return Sys::findProgram("ninja").empty() ? "" : "Ninja";
+    if (requested == "make") return "Unix Makefiles";
+    if (requested == "auto" || requested.empty())
+        return Sys::findProgram("ninja").empty() ? "Unix Makefiles" : "Ninja";
+    return "";
+}
+
+// Generator recorded in an existing CMakeCache.txt, if any.
+std::string cachedGenerator(const std::string& buildPath) {
+    std::ifstream cache(buildPath + "/CMakeCache.txt");
+    std::string line;
+    const std::string key = "CMAKE_GENERATOR:INTERNAL=";
+    while (std::getline(cache, line)) {
+        if (line.compare(0, key.size(), key) == 0) return line.substr(key.size());
+    }
+    return "";
+}
+
+// Everything outside the build tree that can change what `cmake` generates.
+// Edits to CMakeLists.txt are also picked up by the build step itself, but
+// flags, compilers and environment are only seen at configure time.
+std::string configureKey(const std::string& path, const std::vector<std::string>& cmakeArgs) {
+    Hash::Hasher hasher;
+    for (const auto& arg : cmakeArgs) hasher.update(arg);
+    hasher.updateFile(path + "/CMakeLists.txt");
+    hasher.updateFile(path + "/.harbourConfig");
+    const std::pair<const char*, const char*> compilers[] = {{"CXX", "c++"}, {"CC", "cc"}};
+    for (const auto& [var, fallback] : compilers) {
+        const char* value = std::getenv(var);
+        std::string compiler = Sys::findProgram(value ? value : fallback);
+        std::error_code ec;
+        if (!compiler.empty()) compiler = std::filesystem::canonical(compiler, ec).string();
+        hasher.update(compiler);
+    }
+    for (const char* var : {"CXXFLAGS", "CFLAGS", "CPPFLAGS", "LDFLAGS", "CMAKE_PREFIX_PATH",
+                            "CMAKE_GENERATOR", "CMAKE_TOOLCHAIN_FILE", "PKG_CONFIG_PATH"}) {
+        const char* value = std::getenv(var);
+        hasher.update(value ? value : "");
+    }
+    return hasher.hex();
+}
+
+// Built once per toolchain into the artifact cache instead of per project
+const std::vector<std::string> GLFW_OPTIONS = {"-DGLFW_BUILD_EXAMPLES=OFF", "-DGLFW_BUILD_TESTS=OFF",
+                                               "-DGLFW_BUILD_DOCS=OFF", "-DGLFW_INSTALL=ON"};
+
+// Install prefix of a prebuilt GLFW for projects whose CMakeLists.txt can
+// import it, or "" to fall back to add_subdirectory(external/glfw).
+std::string prebuiltGlfw(const std::string& path, const ConfigManager& cfg, bool debugMode) {
+    namespace fs = std::filesystem;
+    if (!cfg.prebuiltDependencies || !fs::exists(path + "/external/glfw/CMakeLists.txt")) return "";
+    std::ifstream lists(path + "/CMakeLists.txt");
+    std::string contents((std::istreambuf_iterator<char>(lists)), std::istreambuf_iterator<char>());
+    if (contents.find("HARBOUR_GLFW_PREFIX") == std::string::npos) return "";
+
+    ArtifactCache cache(cfg.artifactCache);
+    std::string error;
+    std::string prefix = cache.ensure("glfw", path + "/external/glfw", debugMode ? "Debug" : "Release",
+                                      GLFW_OPTIONS, Sys::usableCores(), error);
+    if (prefix.empty()) {
+        std::cout << COLOR_YELLOW << "Could not prebuild GLFW, building it in-tree instead" << COLOR_RESET << std::endl;
+        debug::print(error);
+    }
+    return prefix;
+}
+
+const char* CONFIGURE_STAMP = ".harbour-configure";
+const size_t BUILD_LOG_TAIL = 1 << 20;  // captured bytes kept in memory per stream
+const size_t MAX_AUTO_PCH_HEADERS = 10;
+
+// Top-level #include lines of a translation unit, in order. Includes
+// inside #if blocks are skipped since they may not apply to every TU.
+std::vector<std::string> topLevelIncludes(const std::filesystem::path& source) {
+    std::vector<std::string> includes;
+    std::ifstream in(source);
+    std::string line;
+    int depth = 0;
+    while (std::getline(in, line)) {
+        auto start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] != '#') continue;
+        auto word = line.find_first_not_of(" \t", start + 1);
+        if (word == std::string::npos) continue;
+        if (line.compare(word, 2, "if") == 0) ++depth;
+        else if (line.compare(word, 5, "endif") == 0) --depth;
+        else if (depth == 0 && line.compare(word, 7, "include") == 0) {
+            auto open = line.find_first_of("<\"", word + 7);
+            if (open == std::string::npos) continue;
+            auto close = line.find(line[open] == '<' ? '>' : '"', open + 1);
+            if (close == std::string::npos) continue;
+            std::string header = line.substr(open + 1, close - open - 1);
+            // Quoted includes relative to the source dir need an absolute path
+            // once they are pulled into a header that lives in the build tree
+            auto local = source.parent_path() / header;
+            if (line[open] == '"' && std::filesystem::exists(local))
+                includes.push_back("\"" + std::filesystem::absolute(local).lexically_normal().string() + "\"");
+            else
+                includes.push_back("<" + header + ">");
+        }
+    }
+    return includes;
+}
+
+// Headers included by at least half of the C++ translation units under src/,
+// most frequent first within the cap, emitted in first-seen order so that
+// order-sensitive pairs like glad/GLFW keep working.
+std::vector<std::string> detectPchHeaders(const std::string& path) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> order;
+    std::map<std::string, size_t> counts;
+    size_t units = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(path + "/src", ec)) {
+        auto ext = entry.path().extension();
+        if (!entry.is_regular_file() || (ext != ".cpp" && ext != ".cc" && ext != ".cxx")) continue;
+        ++units;
+        std::set<std::string> seen;
+        for (const auto& header : topLevelIncludes(entry.path())) {
+            if (!seen.insert(header).second) continue;
+            if (counts[header]++ == 0) order.push_back(header);
+        }
+    }
+    size_t threshold = std::max<size_t>(1, (units + 1) / 2);
+    std::vector<std::string> frequent;
+    for (const auto& header : order)
+        if (counts[header] >= threshold) frequent.push_back(header);
+    if (frequent.size() > MAX_AUTO_PCH_HEADERS) {
+        std::vector<std::string> ranked = frequent;
+        std::stable_sort(ranked.begin(), ranked.end(),
+                         [&](const std::string& a, const std::string& b) { return counts[a] > counts[b]; });
+        ranked.resize(MAX_AUTO_PCH_HEADERS);
+        std::set<std::string> keep(ranked.begin(), ranked.end());
+        frequent.erase(std::remove_if(frequent.begin(), frequent.end(),
+                                      [&](const std::string& h) { return !keep.count(h); }),
+                       frequent.end());
+    }
+    return frequent;
+}
+
+// Writes the header CMake precompiles and returns its path, or an empty
+// string when PCH is off. precompiled_headers is "auto", "off" or a comma
+// separated list; unset means auto for graphics projects and off otherwise.
+// The file lives in the per-build-type directory, so debug and release keep
+// separate PCHs, and is only rewritten when its content changes.
+std::string writePchHeader(const std::string& path, const std::string& buildPath, const ConfigManager& cfg) {
+    std::string mode = cfg.precompiledHeaders;
+    if (mode.empty()) mode = cfg.enableGraphics ? "auto" : "off";
+    if (mode == "off" || mode == "false") return "";
+
+    std::vector<std::string> headers;
+    if (mode == "auto") {
+        headers = detectPchHeaders(path);
+    } else {
+        std::stringstream ss(mode);
+        std::string header;
+        while (std::getline(ss, header, ',')) {
+            header.erase(0, header.find_first_not_of(" \t"));
+            header.erase(header.find_last_not_of(" \t") + 1);
+            if (header.empty()) continue;
+            if (header.front() != '<' && header.front() != '"') header = "<" + header + ">";
+            headers.push_back(header);
+        }
+    }
+    if (headers.empty()) return "";
+
+    std::string content = "// Generated by harbour from precompiled_headers; do not edit\n#pragma once\n";
+    for (const auto& header : headers) content += "#include " + header + "\n";
+    std::string pchPath = std::filesystem::absolute(buildPath + "/harbour_pch.hpp").lexically_normal().string();
+    std::ifstream existing(pchPath);
+    std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+    if (current != content) {
+        std::ofstream out(pchPath);
+        out << content;
+    }
+    std::cout << COLOR_YELLOW << "Precompiling " << headers.size() << " header(s)" << COLOR_RESET << std::endl;
+    for (const auto& header : headers) debug::print("  PCH: ", header);
+    return pchPath;
+}
+
+// Writes the unity (jumbo) setup for the project target and returns its
+// path, or an empty string when unity builds are off. Sources are batched
+// in path order until a batch reaches unity_batch_size TUs or
+// unity_batch_bytes of source; files in unity_exclude compile on their own.
+std::string writeUnityFile(const std::string& path, const std::string& buildPath, const ConfigManager& cfg) {
+    namespace fs = std::filesystem;
+    std::set<std::string> excluded;
+    std::stringstream ss(cfg.unityExclude);
+    std::string entry;
+    while (std::getline(ss, entry, ',')) {
+        entry.erase(0, entry.find_first_not_of(" \t"));
+        entry.erase(entry.find_last_not_of(" \t") + 1);
+        if (!entry.empty()) excluded.insert(fs::absolute(path + "/" + entry).lexically_normal().string());
+    }
+
+    std::vector<fs::path> sources;
+    std::error_code ec;
+    for (const auto& file : fs::recursive_directory_iterator(path + "/src", ec)) {
+        auto ext = file.path().extension();
+        if (file.is_regular_file() && (ext == ".cpp" || ext == ".cc" || ext == ".cxx" || ext == ".c"))
+            sources.push_back(fs::absolute(file.path()).lexically_normal());
+    }
+    std::sort(sources.begin(), sources.end());
+
+    std::vector<std::vector<std::string>> batches;
+    std::vector<std::string> skipped;
+    long long batchBytes = 0;
+    for (const auto& source : sources) {
+        if (excluded.count(source.string())) {
+            skipped.push_back(source.string());
+            continue;
+        }
+        bool full = !batches.empty() &&
+                    ((cfg.unityBatchSize > 0 && batches.back().size() >= static_cast<size_t>(cfg.unityBatchSize)) ||
+                     (cfg.unityBatchBytes > 0 && batchBytes >= cfg.unityBatchBytes));
+        if (batches.empty() || full) {
+            batches.emplace_back();
+            batchBytes = 0;
+        }
+        batches.back().push_back(source.string());
+        batchBytes += static_cast<long long>(fs::file_size(source, ec));
+    }
+
+    std::ostringstream out;
+    out << "# Generated by harbour from the unity_* settings; do not edit\n";
+    out << "if(CMAKE_VERSION VERSION_LESS 3.18)\n";
+    out << "    # No explicit grouping before 3.18, fall back to fixed-size batches\n";
+    out << "    set_target_properties(" << cfg.projectName << " PROPERTIES UNITY_BUILD ON UNITY_BUILD_BATCH_SIZE "
+        << std::max(cfg.unityBatchSize, 0) << ")\n";
+    out << "else()\n";
+    out << "    set_target_properties(" << cfg.projectName << " PROPERTIES UNITY_BUILD ON UNITY_BUILD_MODE GROUP)\n";
+    for (size_t i = 0; i < batches.size(); ++i) {
+        out << "    set_source_files_properties(";
+        for (const auto& source : batches[i]) out << "\n        \"" << source << "\"";
+        out << "\n        PROPERTIES UNITY_GROUP \"harbour_unity_" << i << "\")\n";
+    }
+    out << "endif()\n";
+    for (const auto& source : skipped)
+        out << "set_source_files_properties(\"" << source << "\" PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)\n";
+
+    std::string unityPath = fs::absolute(buildPath + "/harbour_unity.cmake").lexically_normal().string();
+    std::ifstream existing(unityPath);
+    std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+    if (current != out.str()) {
+        std::ofstream file(unityPath);
+        file << out.str();
+    }
+    std::cout << COLOR_YELLOW << "Unity build: " << sources.size() - skipped.size() << " sources in "
+              << batches.size() << " batch(es), " << skipped.size() << " excluded" << COLOR_RESET << std::endl;
+    return unityPath;
+}
+
+// Prints the phase timings when the build finishes, whether it succeeded
+// or not, and writes the Chrome trace if one was requested.
+class BuildReport {
+    std::string traceFile;
+    long long start;
+
+public:
+    explicit BuildReport(std::string traceFile)
+        : traceFile(std::move(traceFile)), start(Trace::Recorder::instance().nowUs()) {}
+
+    ~BuildReport() {
+        auto& recorder = Trace::Recorder::instance();
+        long long total = recorder.nowUs() - start;
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        std::cout << COLOR_YELLOW << "Build timings" << COLOR_RESET << std::endl;
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        recorder.printSummary(std::cout, "phase");
+        std::cout << "  " << std::left << std::setw(40) << "Total" << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(10) << total / 1e6 << " s" << std::endl;
+        if (traceFile.empty()) return;
+        if (recorder.writeChromeTrace(traceFile)) {
+            std::cout << COLOR_GREEN << "Wrote trace to " << traceFile << COLOR_RESET << std::endl;
+        } else {
+            std::cerr << COLOR_RED << "Could not write trace to " << traceFile << COLOR_RESET << std::endl;
+        }
+    }
+};
+
+} // namespace
+
+bool Builder::buildProject(const std::string& path, bool debugMode, bool cleanBuild, const BuildOptions& options) {
     namespace fs = std::filesystem;
     std::string buildType = debugMode ? "debug" : "release";
     std::string buildPath = path + "/build/" + buildType;
 
+    Trace::Recorder::instance().clear();
+    BuildReport report(options.traceFile);
+    std::optional<Trace::Scope> phase;
+    phase.emplace("Preparing build", "phase");
+
     if (cleanBuild && fs::exists(buildPath)) {
         std::string rmCmd = "rm -rf " + buildPath;
         debug::print(rmCmd);
         fs::remove_all(buildPath);
     }
 
-    fs::create_directories(buildPath);
-
     ConfigManager cfg;
     if (!cfg.readConfig(path)) return false;
 
+    unsigned jobs = options.jobs > 0 ? options.jobs : cfg.buildJobs > 0 ? cfg.buildJobs : Sys::usableCores();
+    bool useCache = options.compileCache >= 0 ? options.compileCache == 1 : cfg.compileCache;
+    std::string engine = options.engine.empty() ? cfg.buildEngine : options.engine;
+    if (engine != "cmake" && engine != "native") {
+        std::cerr << COLOR_RED << "Unknown build engine: " << engine << COLOR_RESET << std::endl;
+        return false;
+    }
+    if (engine == "native" && !NativeBuilder::supports(path, cfg)) {
+        std::cout << COLOR_YELLOW << "Project needs CMake, not using the native engine" << COLOR_RESET << std::endl;
+        engine = "cmake";
+    }
+    if (engine == "native" && (options.unity >= 0 ? options.unity == 1 : cfg.unityBuild)) {
+        std::cout << COLOR_YELLOW << "Unity builds need CMake, not using the native engine" << COLOR_RESET << std::endl;
+        engine = "cmake";
+    }
+    if (options.profileCompile) {
+        if (engine == "native") {
+            std::cout << COLOR_YELLOW << "Compile profiling needs CMake, not using the native engine" << COLOR_RESET << std::endl;
+            engine = "cmake";
+        }
+        // Cache hits would skip the compiles we are trying to measure
+        if (useCache) std::cout << COLOR_YELLOW << "Compile cache bypassed while profiling" << COLOR_RESET << std::endl;
+        useCache = false;
+        CompileProfiler::reset(buildPath);
+    }
+
+    phase.emplace("Checking for dependencies", "phase");
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
     std::cout << COLOR_YELLOW << "Checking for dependencies..." << COLOR_RESET << std::endl;
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
 
-    DependencyManager dep;
-    if (!dep.checkDependencies(cfg.enableGraphics)) return false;
-
-    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
-    std::cout << COLOR_YELLOW << "Configuring build..." << COLOR_RESET << std::endl;
-    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
-    std::string absProjectRoot = fs::absolute(path);
-    std::string cmakeCmd = "cd '" + buildPath + "' && cmake '" + absProjectRoot + "'";
+    DependencyManager dep(cfg);
+    if (!dep.checkDependencies(cfg.enableGraphics, options.verifyDependencies)) return false;
 
-    if (debugMode) {
-        std::cout << COLOR_YELLOW << "Debug mode enabled" << COLOR_RESET << std::endl;
-        cmakeCmd += " -DCMAKE_CXX_FLAGS=\"-DDEBUG\"";
+    // Semver ranges from a .hrbr manifest; pinned in hrbr.lock after the
+    // first resolution, so later builds only compare the requirements. The
+    // build does not consume the packages yet, so without an index (or a
+    // lock) there is nothing to check and the build goes on.
+    std::string indexDir = cfg.packageIndex.empty() ? Resolver::defaultIndex() : cfg.packageIndex;
+    bool resolvable = !cfg.packageIndex.empty() || fs::exists(indexDir) || fs::exists(path + "/" + Resolver::LOCK_FILE);
+    if (cfg.hasManifest && !cfg.manifest.dependencies.empty() && !resolvable) {
+        std::cout << COLOR_YELLOW << "No package index at " << indexDir << "; .hrbr dependencies not resolved"
+                  << COLOR_RESET << std::endl;
+    } else if (cfg.hasManifest && !cfg.manifest.dependencies.empty()) {
+        std::vector<Resolver::Package> packages;
+        std::string error;
+        bool fromLock = false;
+        Resolver resolver(cfg.packageIndex);
+        if (!resolver.resolveLocked(cfg.manifest.dependencies, path + "/" + Resolver::LOCK_FILE, packages, error,
+                                    &fromLock)) {
+            std::cerr << COLOR_RED << "Cannot resolve .hrbr dependencies: " << error << COLOR_RESET << std::endl;
+            return false;
+        }
+        std::cout << COLOR_GREEN << packages.size() << " .hrbr package(s) "
+                  << (fromLock ? "locked in " : "resolved into ") << Resolver::LOCK_FILE << COLOR_RESET << std::endl;
     }
-    debug::print(cmakeCmd);
 
-    Harbour::CommandExecutor exec;
-    auto cmakeArgs = std::vector<std::string>{"/bin/sh", "-c", cmakeCmd};
-    auto cmakeResult = exec.run(cmakeArgs, true);
-    if (cmakeResult.exitCode != 0) {
-        debug::print("CMake failed: ", cmakeResult.error, cmakeResult.output);
+    phase.reset();
+    if (engine == "native") {
+        phase.emplace("Building project (native)", "phase");
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        std::cout << COLOR_YELLOW << "Building project (native engine, " << jobs << " parallel jobs)..." << COLOR_RESET << std::endl;
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        fs::create_directories(buildPath);
+        NativeBuilder native;
+        if (!native.build(path, buildPath, cfg, debugMode, jobs, useCache)) return false;
+    } else if (!buildWithCMake(path, buildPath, cfg, debugMode, options, jobs, useCache)) {
         return false;
     }
 
-    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
-    std::cout << COLOR_YELLOW << "Building project..." << COLOR_RESET << std::endl;
-    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
-    std::string makeCmd = "cd '" + buildPath + "' && make";
-
-    debug::print(makeCmd);
-
-    auto makeArgs = std::vector<std::string>{"/bin/sh", "-c", makeCmd};
-    auto makeResult = exec.run(makeArgs, true);
-    if (makeResult.exitCode != 0) {
-        debug::print("Make failed: ", makeResult.error, makeResult.output);
-        return false;
+    if (options.profileCompile) {
+        phase.emplace("Compile profile", "phase");
+        CompileProfiler profiler;
+        if (!profiler.collect(buildPath)) {
+            std::cout << COLOR_YELLOW << "No translation units were compiled; use -c to profile a full rebuild" << COLOR_RESET << std::endl;
+        } else {
+            profiler.report(std::cout);
+            long long budget = options.compileBudgetMs >= 0 ? options.compileBudgetMs : cfg.compileBudgetMs;
+            auto over = profiler.overBudget(budget);
+            if (!over.empty()) {
+                std::cerr << COLOR_RED << over.size() << " translation unit(s) exceeded the " << budget
+                          << " ms compile budget:" << COLOR_RESET << std::endl;
+                for (const auto& unit : over) std::cerr << "  " << unit.source << " (" << unit.wallMs << " ms)" << std::endl;
+                return false;
+            }
+        }
     }
 
+    phase.emplace("Linking the Compile Commands", "phase");
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
     std::cout << COLOR_YELLOW << "Linking the Compile Commands for clangd" << COLOR_RESET << std::endl;
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
@@ -85,6 +432,7 @@ bool Builder::buildProject(const std::string& path, bool debugMode, bool cleanBu
     }
 
 
+    phase.reset();
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
     std::cout << COLOR_GREEN << "Done! Run it via 'harbour run'" << COLOR_RESET << std::endl;
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
@@ -92,5 +440,134 @@ bool Builder::buildProject(const std::string& path, bool debugMode, bool cleanBu
     return true;
 }
 
+bool Builder::configureWithCMake(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+                                 bool debugMode, const BuildOptions& options, const std::string& generator,
+                                 bool useCache) {
+    namespace fs = std::filesystem;
+    Trace::Scope phase("Configuring build", "phase");
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_YELLOW << "Configuring build..." << COLOR_RESET << std::endl;
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::string absProjectRoot = fs::absolute(path);
+    // Run in buildPath, so the build directory is implied
+    std::vector<std::string> cmakeArgs = {"cmake", "-G", generator, absProjectRoot};
+
+    if (debugMode) {
+        std::cout << COLOR_YELLOW << "Debug mode enabled" << COLOR_RESET << std::endl;
+        cmakeArgs.push_back("-DCMAKE_CXX_FLAGS=-DDEBUG");
+    }
+
+    // Route compiles through `harbour cache exec`, or C++ compiles through
+    // `harbour profile exec` when profiling; an empty launcher turns a
+    // previously enabled one back off.
+    std::string launcher, cxxLauncher;
+    if (useCache || options.profileCompile) {
+        std::error_code ec;
+        std::string self = fs::read_symlink("/proc/self/exe", ec).string();
+        if (ec) {
+            std::cerr << COLOR_RED << "Cannot locate the harbour executable for the compiler launcher" << COLOR_RESET << std::endl;
+            return false;
+        }
+        if (useCache) {
+            std::cout << COLOR_YELLOW << "Compile cache enabled" << COLOR_RESET << std::endl;
+            launcher = self + ";cache;exec;--base-dir;" + absProjectRoot + ";--";
+        }
+        cxxLauncher = launcher;
+        if (options.profileCompile) {
+            std::string flag = CompileProfiler::timeFlag();
+            std::cout << COLOR_YELLOW << "Profiling compiles with " << flag << COLOR_RESET << std::endl;
+            cxxLauncher = self + ";profile;exec;--flag;" + flag + ";--";
+        }
+    }
+    cmakeArgs.push_back("-DCMAKE_CXX_COMPILER_LAUNCHER=" + cxxLauncher);
+    cmakeArgs.push_back("-DCMAKE_C_COMPILER_LAUNCHER=" + launcher);
+    cmakeArgs.push_back("-DHARBOUR_PCH_HEADER=" + writePchHeader(path, buildPath, cfg));
+    bool unity = options.unity >= 0 ? options.unity == 1 : cfg.unityBuild;
+    cmakeArgs.push_back("-DHARBOUR_UNITY_FILE=" + (unity ? writeUnityFile(path, buildPath, cfg) : ""));
+    if (cfg.enableGraphics) cmakeArgs.push_back("-DHARBOUR_GLFW_PREFIX=" + prebuiltGlfw(path, cfg, debugMode));
+    for (const auto& arg : cmakeArgs) debug::print("  ", arg);
+
+    std::string stampPath = buildPath + "/" + CONFIGURE_STAMP;
+    std::string key = configureKey(path, cmakeArgs);
+    std::string previousKey;
+    {
+        std::ifstream stamp(stampPath);
+        std::getline(stamp, previousKey);
+    }
+
+    if (previousKey == key && fs::exists(buildPath + "/CMakeCache.txt")) {
+        std::cout << COLOR_GREEN << "Configuration unchanged, skipping CMake configure." << COLOR_RESET << std::endl;
+    } else {
+        // Drop the stamp first so a failed configure is never mistaken for a good one
+        fs::remove(stampPath);
+        CommandExecutor::Options cmakeOptions;
+        cmakeOptions.cwd = buildPath;
+        cmakeOptions.maxCaptureBytes = BUILD_LOG_TAIL;
+        cmakeOptions.onLine = [](CommandExecutor::Stream, std::string_view line) { debug::print(line); };
+        CommandExecutor exec;
+        auto cmakeResult = exec.run(cmakeArgs, cmakeOptions);
+        if (cmakeResult.exitCode != 0) {
+            std::cerr << COLOR_RED << "CMake configure failed:" << COLOR_RESET << std::endl;
+            std::cerr << cmakeResult.output << cmakeResult.error;
+            return false;
+        }
+        std::ofstream stamp(stampPath);
+        stamp << key << "\n";
+    }
+    return true;
+}
+
+bool Builder::buildWithCMake(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+                             bool debugMode, const BuildOptions& options, unsigned jobs, bool useCache) {
+    namespace fs = std::filesystem;
+    std::string generatorName = options.generator.empty() ? cfg.buildGenerator : options.generator;
+    std::string generator = resolveGenerator(generatorName);
+    if (generator.empty()) {
+        std::cerr << COLOR_RED << "Unusable build generator: " << generatorName << COLOR_RESET << std::endl;
+        return false;
+    }
+
+    // CMake refuses to switch generators in place, so start over
+    std::string previous = cachedGenerator(buildPath);
+    if (!previous.empty() && previous != generator) {
+        debug::print("Generator changed from ", previous, " to ", generator, ", wiping ", buildPath);
+        fs::remove_all(buildPath);
+    }
+
+    fs::create_directories(buildPath);
+
+    if (options.reuseConfiguration && previous == generator && fs::exists(buildPath + "/" + CONFIGURE_STAMP)) {
+        std::cout << COLOR_GREEN << "Only sources changed, reusing the existing configuration." << COLOR_RESET << std::endl;
+    } else if (!configureWithCMake(path, buildPath, cfg, debugMode, options, generator, useCache)) {
+        return false;
+    }
+
+    Trace::Scope phase("Building project", "phase");
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_YELLOW << "Building project..." << COLOR_RESET << std::endl;
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_YELLOW << "Using " << generator << " with " << jobs << " parallel jobs" << COLOR_RESET << std::endl;
+    // Compiler output is echoed as it arrives; only the tail stays in
+    // memory and a long log goes to disk in full.
+    auto makeArgs = std::vector<std::string>{"cmake", "--build", buildPath, "--parallel", std::to_string(jobs)};
+    CommandExecutor::Options makeOptions;
+    makeOptions.maxCaptureBytes = BUILD_LOG_TAIL;
+    makeOptions.spillPath = buildPath + "/harbour-build";
+    makeOptions.onLine = [](CommandExecutor::Stream stream, std::string_view line) {
+        (stream == CommandExecutor::Stream::Err ? std::cerr : std::cout) << line << '\n';
+    };
+    CommandExecutor exec;
+    auto makeResult = exec.run(makeArgs, makeOptions);
+    std::cout.flush();
+    if (makeResult.exitCode != 0) {
+        std::cerr << COLOR_RED << "Build step failed";
+        if (!makeResult.outputSpill.empty() || !makeResult.errorSpill.empty())
+            std::cerr << ", full log in " << buildPath << "/harbour-build.{stdout,stderr}";
+        std::cerr << COLOR_RESET << std::endl;
+        return false;
+    }
+    return true;
+}
+
 } // namespace Project
 } // namespace Harbour 
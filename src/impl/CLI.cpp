@@ -1,18 +1,107 @@
+#include <algorithm>
+#include <climits>
 #include <filesystem>
+#include <limits>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "harbour.hpp"
+#include "numbers.hpp"
 
 namespace Harbour {
 namespace Project {
 
+namespace {
+
+// A numeric flag value; prints the error itself so callers only bail out
+bool integerFlag(const std::string &flag, const std::string &value,
+                 long long min, long long max, long long &out) {
+  if (Numbers::parseInteger(value, min, max, out))
+    return true;
+  std::cerr << COLOR_RED << "Invalid value for " << flag << ": " << value
+            << COLOR_RESET << std::endl;
+  return false;
+}
+
+bool decimalFlag(const std::string &flag, const std::string &value, double min,
+                 double max, double &out) {
+  if (Numbers::parseDecimal(value, min, max, out))
+    return true;
+  std::cerr << COLOR_RED << "Invalid value for " << flag << ": " << value
+            << COLOR_RESET << std::endl;
+  return false;
+}
+
+} // namespace
+
+bool CLI::parseBuildFlags(int argc, char *argv[], int &i, bool &debugMode,
+                          bool &cleanBuild, BuildOptions &options) {
+  while (i < argc && argv[i][0] == '-') {
+    std::string opt = argv[i];
+    if (opt == "-d") {
+      debugMode = true;
+    } else if (opt == "-c" || opt == "--clean") {
+      cleanBuild = true;
+    } else if ((opt == "-j" || opt == "--jobs") && i + 1 < argc) {
+      long long jobs = 0;
+      if (!integerFlag(opt, argv[++i], 1, INT_MAX, jobs))
+        return false;
+      options.jobs = static_cast<int>(jobs);
+    } else if (opt.rfind("-j", 0) == 0 && opt.size() > 2) {
+      long long jobs = 0;
+      if (!integerFlag("-j", opt.substr(2), 1, INT_MAX, jobs))
+        return false;
+      options.jobs = static_cast<int>(jobs);
+    } else if (opt == "--generator" && i + 1 < argc) {
+      options.generator = argv[++i];
+    } else if (opt == "--engine" && i + 1 < argc) {
+      options.engine = argv[++i];
+    } else if (opt == "--trace" && i + 1 < argc) {
+      options.traceFile = argv[++i];
+    } else if (opt == "--unity") {
+      options.unity = 1;
+    } else if (opt == "--no-unity") {
+      options.unity = 0;
+    } else if (opt == "--cache") {
+      options.compileCache = 1;
+    } else if (opt == "--no-cache") {
+      options.compileCache = 0;
+    } else if (opt == "--verify") {
+      options.verifyDependencies = true;
+    } else if (opt == "--profile-compile") {
+      options.profileCompile = true;
+    } else if (opt == "--compile-budget" && i + 1 < argc) {
+      options.profileCompile = true;
+      if (!integerFlag(opt, argv[++i], 0, LLONG_MAX, options.compileBudgetMs))
+        return false;
+    } else {
+      std::cout << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+                << std::endl;
+      return false;
+    }
+    ++i;
+  }
+  return true;
+}
+
 int CLI::run(int argc, char *argv[]) {
   if (argc < 2) {
     std::cout << "Usage: " << argv[0] << " <command> [options]\n";
     std::cout << "Commands:\n  new <project_name> [options]\n  build [-d] "
-                 "[-c|--clean] [path]\n  run [path]\n  make [-d] [-c|--clean] "
-                 "[path]\n";
+                 "[-c|--clean] [-j <jobs>] [--generator <ninja|make|auto>] "
+                 "[--[no-]cache] [--engine <cmake|native>] [--[no-]unity] "
+                 "[--trace <file>] [--profile-compile] [--compile-budget <ms>] "
+                 "[--verify] [path]\n  watch [build options] [--run] [--debounce <ms>] "
+                 "[path]\n  run [--log <file>] [--perf] [--perf-threads] "
+                 "[--perf-output <file>] [--timeout <ms>] [path]\n"
+                 "  bench [-n <runs>] [-w <warmups>] [--save <name>] "
+                 "[--compare <name>] [--threshold <percent>] [path] [-- <args>]\n"
+                 "  make [-d] [-c|--clean] [-j <jobs>] "
+                 "[--generator <ninja|make|auto>] [--[no-]cache] "
+                 "[--engine <cmake|native>] [--[no-]unity] [--trace <file>] "
+                 "[--profile-compile] [--compile-budget <ms>] [--verify] "
+                 "[path]\n  resolve [--update] [path]\n  cache <stats|clear>\n  daemon <start|stop|status|run>\n";
     return 1;
   }
   std::string cmd = argv[1];
@@ -29,7 +118,10 @@ int CLI::run(int argc, char *argv[]) {
     while (i < argc && argv[i][0] == '-') {
       std::string opt = argv[i];
       if (opt == "-v" && i + 1 < argc) {
-        cppVersion = std::stoi(argv[++i]);
+        long long version = 0;
+        if (!integerFlag(opt, argv[++i], 1, 99, version))
+          return 1;
+        cppVersion = static_cast<int>(version);
       } else if (opt == "-b" && i + 1 < argc) {
         runtimeBin = argv[++i];
       } else if (opt == "-l" && i + 1 < argc) {
@@ -80,7 +172,9 @@ int CLI::run(int argc, char *argv[]) {
                 << COLOR_RESET << std::endl;
       std::string oldCwd = std::filesystem::current_path();
       std::filesystem::current_path("./" + projectName);
-      DependencyManager dep;
+      ConfigManager cfg;
+      cfg.readConfig(".");
+      DependencyManager dep(cfg);
       if (!dep.checkDependencies(true)) {
         std::cerr << COLOR_RED << "Failed to clone dependencies." << COLOR_RESET
                   << std::endl;
@@ -109,70 +203,301 @@ int CLI::run(int argc, char *argv[]) {
   } else if (cmd == "build") {
     bool debugMode = false;
     bool cleanBuild = false;
+    BuildOptions options;
     std::string buildPath = ".";
     int i = 2;
-    while (i < argc && argv[i][0] == '-') {
-      std::string opt = argv[i];
-      if (opt == "-d") {
-        debugMode = true;
-      } else if (opt == "-c" || opt == "--clean") {
-        cleanBuild = true;
-      } else {
-        std::cout << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
-                  << std::endl;
-        return 1;
-      }
-      ++i;
+    if (!parseBuildFlags(argc, argv, i, debugMode, cleanBuild, options)) {
+      return 1;
     }
     if (i < argc) {
       buildPath = argv[i];
     }
+    // Hand the build to harbourd when it is running
+    int daemonCode = 0;
+    if (Daemon::forward(std::vector<std::string>(argv + 1, argv + argc),
+                        daemonCode)) {
+      return daemonCode;
+    }
     Builder builder;
-    if (!builder.buildProject(buildPath, debugMode, cleanBuild)) {
+    if (!builder.buildProject(buildPath, debugMode, cleanBuild, options)) {
       std::cerr << COLOR_RED << "Build failed." << COLOR_RESET << std::endl;
       return 1;
     }
+  } else if (cmd == "watch") {
+    // watch takes the build flags plus its own; split those out first
+    bool rerun = false;
+    int debounceMs = 200;
+    std::vector<char *> buildArgs(argv, argv + 2);
+    for (int j = 2; j < argc; ++j) {
+      std::string opt = argv[j];
+      if (opt == "--run") {
+        rerun = true;
+      } else if (opt == "--debounce" && j + 1 < argc) {
+        long long debounce = 0;
+        if (!integerFlag(opt, argv[++j], 0, INT_MAX, debounce))
+          return 1;
+        debounceMs = static_cast<int>(debounce);
+      } else {
+        buildArgs.push_back(argv[j]);
+      }
+    }
+    bool debugMode = false;
+    bool cleanBuild = false;
+    BuildOptions options;
+    std::string watchPath = ".";
+    int i = 2;
+    if (!parseBuildFlags(buildArgs.size(), buildArgs.data(), i, debugMode,
+                         cleanBuild, options)) {
+      return 1;
+    }
+    if (i < static_cast<int>(buildArgs.size())) {
+      watchPath = buildArgs[i];
+    }
+    if (cleanBuild) {
+      std::cout << COLOR_RED << "watch does not support --clean" << COLOR_RESET
+                << std::endl;
+      return 1;
+    }
+    Watcher watcher(watchPath, debugMode, options, rerun, debounceMs);
+    return watcher.run();
   } else if (cmd == "run") {
     std::string runPath = ".";
-    if (argc > 2) {
-      runPath = argv[2];
+    RunOptions runOptions;
+    for (int i = 2; i < argc; ++i) {
+      std::string opt = argv[i];
+      if (opt == "--log" && i + 1 < argc) {
+        runOptions.logFile = argv[++i];
+      } else if (opt == "--perf") {
+        runOptions.perf = true;
+      } else if (opt == "--perf-threads") {
+        runOptions.perf = true;
+        runOptions.perfThreads = true;
+      } else if (opt == "--perf-output" && i + 1 < argc) {
+        runOptions.perf = true;
+        runOptions.perfOutput = argv[++i];
+      } else if (opt == "--timeout" && i + 1 < argc) {
+        long long timeout = 0;
+        if (!integerFlag(opt, argv[++i], 0, UINT_MAX, timeout))
+          return 1;
+        runOptions.timeoutMs = static_cast<unsigned>(timeout);
+      } else if (opt[0] == '-') {
+        std::cerr << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+                  << std::endl;
+        return 1;
+      } else {
+        runPath = opt;
+      }
     }
     Runner runner;
-    if (!runner.runProject(runPath)) {
+    if (!runner.runProject(runPath, runOptions)) {
       std::cerr << COLOR_RED << "Run failed." << COLOR_RESET << std::endl;
       return 1;
     }
-  } else if (cmd == "make") {
-    bool debugMode = false;
-    bool cleanBuild = false;
-    std::string makePath = ".";
+  } else if (cmd == "bench") {
+    // bench [options] [path] [-- <program args...>]
+    BenchOptions options;
+    std::string benchPath = ".";
     int i = 2;
-    while (i < argc && argv[i][0] == '-') {
+    for (; i < argc; ++i) {
       std::string opt = argv[i];
-      if (opt == "-d") {
-        debugMode = true;
-      } else if (opt == "-c" || opt == "--clean") {
-        cleanBuild = true;
-      } else {
-        std::cout << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+      if (opt == "--") {
+        options.args.assign(argv + i + 1, argv + argc);
+        break;
+      } else if ((opt == "-n" || opt == "--runs") && i + 1 < argc) {
+        long long runs = 0;
+        if (!integerFlag(opt, argv[++i], 1, INT_MAX, runs))
+          return 1;
+        options.runs = static_cast<int>(runs);
+      } else if ((opt == "-w" || opt == "--warmup") && i + 1 < argc) {
+        long long warmups = 0;
+        if (!integerFlag(opt, argv[++i], 0, INT_MAX, warmups))
+          return 1;
+        options.warmups = static_cast<int>(warmups);
+      } else if (opt == "--save" && i + 1 < argc) {
+        options.save = argv[++i];
+      } else if (opt == "--compare" && i + 1 < argc) {
+        options.compare = argv[++i];
+      } else if (opt == "--threshold" && i + 1 < argc) {
+        // A percentage; zero would flag every slower run as a regression
+        double percent = 0;
+        if (!decimalFlag(opt, argv[++i], std::numeric_limits<double>::min(),
+                         std::numeric_limits<double>::max(), percent))
+          return 1;
+        options.threshold = percent / 100;
+      } else if (opt[0] == '-') {
+        std::cerr << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
                   << std::endl;
         return 1;
+      } else {
+        benchPath = opt;
       }
-      ++i;
+    }
+    Bencher bencher;
+    if (!bencher.benchProject(benchPath, options)) {
+      std::cerr << COLOR_RED << "Benchmark failed." << COLOR_RESET << std::endl;
+      return 1;
+    }
+  } else if (cmd == "make") {
+    bool debugMode = false;
+    bool cleanBuild = false;
+    BuildOptions options;
+    std::string makePath = ".";
+    int i = 2;
+    if (!parseBuildFlags(argc, argv, i, debugMode, cleanBuild, options)) {
+      return 1;
     }
     if (i < argc) {
       makePath = argv[i];
     }
-    Builder builder;
-    if (!builder.buildProject(makePath, debugMode, cleanBuild)) {
-      std::cerr << COLOR_RED << "Build failed." << COLOR_RESET << std::endl;
-      return 1;
+    // Only the build goes to harbourd; the program runs here, in our terminal
+    std::vector<std::string> buildArgs = {"build"};
+    buildArgs.insert(buildArgs.end(), argv + 2, argv + argc);
+    int daemonCode = 0;
+    if (Daemon::forward(buildArgs, daemonCode)) {
+      if (daemonCode != 0)
+        return daemonCode;
+    } else {
+      Builder builder;
+      if (!builder.buildProject(makePath, debugMode, cleanBuild, options)) {
+        std::cerr << COLOR_RED << "Build failed." << COLOR_RESET << std::endl;
+        return 1;
+      }
     }
     Runner runner;
     if (!runner.runProject(makePath)) {
       std::cerr << COLOR_RED << "Run failed." << COLOR_RESET << std::endl;
       return 1;
     }
+  } else if (cmd == "resolve") {
+    // resolve [--update] [path]: pin the .hrbr ranges into hrbr.lock
+    bool update = false;
+    std::string projectPath = ".";
+    for (int i = 2; i < argc; ++i) {
+      std::string opt = argv[i];
+      if (opt == "--update") {
+        update = true;
+      } else if (opt[0] == '-') {
+        std::cerr << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+                  << std::endl;
+        return 1;
+      } else {
+        projectPath = opt;
+      }
+    }
+    ConfigManager cfg;
+    cfg.readConfig(projectPath);
+    std::string lockPath = projectPath + "/" + Resolver::LOCK_FILE;
+    if (update) std::filesystem::remove(lockPath);
+    Resolver::Requirements requirements;
+    std::vector<Resolver::Package> packages;
+    std::string error;
+    bool fromLock = false;
+    Resolver resolver(cfg.packageIndex);
+    if (!Resolver::readManifest(projectPath + "/.hrbr", requirements, error) ||
+        !resolver.resolveLocked(requirements, lockPath, packages, error,
+                                &fromLock)) {
+      std::cerr << COLOR_RED << "Resolution failed: " << error << COLOR_RESET
+                << std::endl;
+      return 1;
+    }
+    for (const auto &package : packages) {
+      std::cout << "  " << package.name << " " << package.version;
+      if (!package.dependencies.empty()) {
+        std::cout << " (needs";
+        for (const auto &dep : package.dependencies) std::cout << " " << dep;
+        std::cout << ")";
+      }
+      std::cout << std::endl;
+    }
+    std::cout << COLOR_GREEN << packages.size() << " package(s) "
+              << (fromLock ? "locked in " : "written to ") << lockPath
+              << COLOR_RESET << std::endl;
+  } else if (cmd == "cache") {
+    std::string sub = argc > 2 ? argv[2] : "stats";
+    CompileCache cache;
+    if (sub == "exec") {
+      // Compiler launcher: cache exec [--base-dir <dir>] -- <compiler> <args...>
+      std::string baseDir;
+      int i = 3;
+      while (i < argc && std::string(argv[i]) != "--") {
+        std::string opt = argv[i];
+        if (opt == "--base-dir" && i + 1 < argc) {
+          baseDir = argv[++i];
+        } else {
+          std::cerr << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+                    << std::endl;
+          return 1;
+        }
+        ++i;
+      }
+      std::vector<std::string> compilerArgs(argv + std::min(i + 1, argc), argv + argc);
+      return cache.exec(baseDir, compilerArgs);
+    } else if (sub == "stats") {
+      cache.printStats();
+    } else if (sub == "clear") {
+      if (!cache.clear()) {
+        std::cerr << COLOR_RED << "Failed to clear " << cache.getDir()
+                  << COLOR_RESET << std::endl;
+        return 1;
+      }
+      std::cout << COLOR_GREEN << "Cleared compile cache." << COLOR_RESET
+                << std::endl;
+    } else {
+      std::cout << COLOR_RED << "Unknown cache command: " << sub << COLOR_RESET
+                << std::endl;
+      return 1;
+    }
+  } else if (cmd == "daemon") {
+    std::string sub = argc > 2 ? argv[2] : "status";
+    if (sub == "run") {
+      Daemon daemon;
+      return daemon.serve();
+    } else if (sub == "start") {
+      if (!Daemon::start()) {
+        std::cerr << COLOR_RED << "harbourd is already running or failed to start ("
+                  << Daemon::socketPath() << ")" << COLOR_RESET << std::endl;
+        return 1;
+      }
+      std::cout << COLOR_GREEN << "harbourd started on " << Daemon::socketPath()
+                << COLOR_RESET << std::endl;
+    } else if (sub == "stop" || sub == "status") {
+      int code = 0;
+      if (!Daemon::forward({"daemon", sub}, code)) {
+        std::cout << COLOR_YELLOW << "harbourd is not running" << COLOR_RESET
+                  << std::endl;
+        return sub == "stop" ? 0 : 1;
+      }
+      return code;
+    } else {
+      std::cout << COLOR_RED << "Unknown daemon command: " << sub << COLOR_RESET
+                << std::endl;
+      return 1;
+    }
+  } else if (cmd == "profile") {
+    // Compiler launcher used by --profile-compile:
+    // profile exec [--flag <timing flag>] -- <compiler> <args...>
+    std::string sub = argc > 2 ? argv[2] : "";
+    if (sub != "exec") {
+      std::cout << COLOR_RED << "Unknown profile command: " << sub
+                << COLOR_RESET << std::endl;
+      return 1;
+    }
+    std::string flag;
+    int i = 3;
+    while (i < argc && std::string(argv[i]) != "--") {
+      std::string opt = argv[i];
+      if (opt == "--flag" && i + 1 < argc) {
+        flag = argv[++i];
+      } else {
+        std::cerr << COLOR_RED << "Unknown option: " << opt << COLOR_RESET
+                  << std::endl;
+        return 1;
+      }
+      ++i;
+    }
+    std::vector<std::string> compilerArgs(argv + std::min(i + 1, argc), argv + argc);
+    CompileProfiler profiler;
+    return profiler.exec(flag, compilerArgs);
   } else {
     std::cout << COLOR_RED << "Unknown command: " << cmd << COLOR_RESET
               << std::endl;
@@ -1,56 +1,1013 @@
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <fcntl.h>
-#include <sstream>
 #include "harbour.hpp"
+#include "sysinfo.hpp"
+#include "trace.hpp"
 
 namespace Harbour {
 
-CommandExecutor::Result CommandExecutor::run(const std::vector<std::string>& args, bool captureOutput) {
-    int outPipe[2], errPipe[2];
-    pid_t pid;
-    std::ostringstream outStream, errStream;
-    int status = -1;
+namespace {
+
+// Lines longer than this are handed to the callback in pieces
+const size_t MAX_LINE_BYTES = 64 * 1024;
+
+// Short label for trace events: the script for `sh -c`, otherwise argv
+std::string describe(const std::vector<std::string>& args) {
+    std::string label;
+    if (args.size() >= 3 && args[1] == "-c") {
+        label = args[2];
+    } else {
+        for (const auto& a : args) label += (label.empty() ? "" : " ") + a;
+    }
+    return label.size() > 120 ? label.substr(0, 117) + "..." : label;
+}
+
+// Collects one output stream: splits it into lines for the callback and
+// keeps the capture within its cap, spilling to disk once it overflows.
+class Sink {
+public:
+    Sink(CommandExecutor::Stream stream, const CommandExecutor::Options& options, std::string spillFile)
+        : stream(stream), options(options), spillFile(std::move(spillFile)) {}
+
+    void append(const char* data, size_t size) {
+        if (options.onLine) {
+            partial.append(data, size);
+            size_t start = 0, nl;
+            while ((nl = partial.find('\n', start)) != std::string::npos) {
+                options.onLine(stream, std::string_view(partial).substr(start, nl - start));
+                start = nl + 1;
+            }
+            partial.erase(0, start);
+            if (partial.size() >= MAX_LINE_BYTES) {
+                options.onLine(stream, partial);
+                partial.clear();
+            }
+        }
+        if (!options.capture) return;
+        if (spill.is_open()) spill.write(data, size);
+        captured.append(data, size);
+        size_t cap = options.maxCaptureBytes;
+        if (cap == 0 || captured.size() <= cap) return;
+        truncated = true;
+        if (!spillFile.empty() && !spill.is_open()) {
+            // Nothing has been dropped yet, so the file starts complete
+            spill.open(spillFile, std::ios::binary | std::ios::trunc);
+            spill.write(captured.data(), captured.size());
+        }
+        // Trim lazily so the tail costs amortized O(1) per byte
+        if (captured.size() > 2 * cap) captured.erase(0, captured.size() - cap);
+    }
+
+    void finish() {
+        if (options.onLine && !partial.empty()) options.onLine(stream, partial);
+        partial.clear();
+        size_t cap = options.maxCaptureBytes;
+        if (cap > 0 && captured.size() > cap) captured.erase(0, captured.size() - cap);
+        if (spill.is_open()) spill.close();
+    }
+
+    std::string captured;
+    bool truncated = false;
+    std::string spilledTo() const { return truncated && !spillFile.empty() ? spillFile : ""; }
+
+private:
+    CommandExecutor::Stream stream;
+    const CommandExecutor::Options& options;
+    std::string spillFile;
+    std::string partial;
+    std::ofstream spill;
+};
+
+// Moves one output stream to the terminal (and the tee log) inside the
+// kernel. The stream is spliced into the log and sent on from there with
+// sendfile(2), or spliced straight to the terminal when there is no log.
+// For the tail, tee(2) duplicates each chunk into a side pipe that is
+// trimmed to tailBytes, so only the tail is ever read into memory.
+class Forwarder {
+public:
+    Forwarder(int target, int log, off_t& logOffset, size_t tailBytes)
+        : target(target), log(log), logOffset(logOffset), tailBytes(tailBytes) {
+        if (tailBytes == 0 || pipe2(tailPipe, O_CLOEXEC | O_NONBLOCK) != 0) return;
+        // Room for the tail plus one full chunk, when the kernel allows it
+        fcntl(tailPipe[1], F_SETPIPE_SZ, static_cast<int>(tailBytes + 65536));
+        devNull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    }
+
+    ~Forwarder() {
+        for (int fd : {tailPipe[0], tailPipe[1], devNull})
+            if (fd >= 0) close(fd);
+    }
+
+    // Forwards what is waiting in source; false once it reached EOF
+    bool pump(int source) {
+        int available = 0;
+        if (ioctl(source, FIONREAD, &available) != 0 || available <= 0) return false;
+        size_t len = static_cast<size_t>(available);
+        if (tailPipe[0] >= 0) {
+            ssize_t copied = tee(source, tailPipe[1], len, SPLICE_F_NONBLOCK);
+            if (copied < 0 && errno == EAGAIN) {
+                // Side pipe out of slots: drop the old tail, keep the new data
+                trimTail(0);
+                copied = tee(source, tailPipe[1], len, SPLICE_F_NONBLOCK);
+            }
+            if (copied > 0) len = static_cast<size_t>(copied);
+            seen += len;
+            trimTail(tailBytes);
+        }
+        return log >= 0 ? toLog(source, len) : toTarget(source, len);
+    }
+
+    // The last tailBytes of the stream; truncated if more went past
+    std::string finish(bool& truncated) {
+        std::string tail;
+        if (tailPipe[0] < 0) return tail;
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(tailPipe[0], buf, sizeof(buf))) > 0) tail.append(buf, static_cast<size_t>(n));
+        if (tail.size() > tailBytes) tail.erase(0, tail.size() - tailBytes);
+        truncated = truncated || seen > tailBytes;
+        return tail;
+    }
+
+private:
+    int target;
+    int log;
+    off_t& logOffset;
+    size_t tailBytes;
+    size_t seen = 0;
+    int tailPipe[2] = {-1, -1};
+    int devNull = -1;
+
+    void trimTail(size_t keep) {
+        int queued = 0;
+        if (ioctl(tailPipe[0], FIONREAD, &queued) != 0 || static_cast<size_t>(queued) <= keep) return;
+        size_t excess = static_cast<size_t>(queued) - keep;
+        char buf[4096];
+        while (excess > 0) {
+            ssize_t n = devNull >= 0 ? splice(tailPipe[0], nullptr, devNull, nullptr, excess, SPLICE_F_NONBLOCK)
+                                     : read(tailPipe[0], buf, std::min(excess, sizeof(buf)));
+            if (n <= 0) break;
+            excess -= static_cast<size_t>(n);
+        }
+    }
+
+    bool toLog(int source, size_t len) {
+        while (len > 0) {
+            off_t start = logOffset;
+            ssize_t n = splice(source, nullptr, log, &logOffset, len, SPLICE_F_MOVE);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                // The log rejects splicing; forward the rest without it
+                log = -1;
+                return toTarget(source, len);
+            }
+            len -= static_cast<size_t>(n);
+            off_t from = start;
+            while (target >= 0 && from < logOffset) {
+                ssize_t sent = sendfile(target, log, &from, static_cast<size_t>(logOffset - from));
+                if (sent < 0 && errno == EINTR) continue;
+                if (sent <= 0) copyRange(from, logOffset);
+            }
+        }
+        return true;
+    }
+
+    // Fallback for terminals sendfile cannot write to
+    void copyRange(off_t& from, off_t to) {
+        char buf[65536];
+        while (from < to) {
+            ssize_t n = pread(log, buf, std::min(sizeof(buf), static_cast<size_t>(to - from)), from);
+            if (n <= 0 || !writeAll(buf, static_cast<size_t>(n))) break;
+            from += n;
+        }
+        from = to;
+    }
+
+    bool toTarget(int source, size_t len) {
+        char buf[65536];
+        while (len > 0) {
+            ssize_t n = target >= 0 ? splice(source, nullptr, target, nullptr, len, SPLICE_F_MOVE) : -1;
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                // Terminals and O_APPEND files refuse splice; copy this chunk
+                n = read(source, buf, std::min(len, sizeof(buf)));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                if (target >= 0 && !writeAll(buf, static_cast<size_t>(n))) target = -1;
+            }
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = write(target, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+};
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 29)
+#define HARBOUR_SPAWN_CHDIR 1
+#endif
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 34)
+#define HARBOUR_SPAWN_CLOSEFROM 1
+#endif
+
+// Our environment with the NAME=value overrides applied
+std::vector<std::string> mergedEnvironment(const std::vector<std::string>& overrides) {
+    std::vector<std::string> merged;
+    for (char** entry = environ; *entry; ++entry) {
+        std::string_view current(*entry);
+        auto eq = current.find('=');
+        bool replaced = false;
+        // An entry without '=' has no name to override; it is passed on as is
+        if (eq != std::string_view::npos) {
+            std::string_view name = current.substr(0, eq + 1);
+            for (const auto& o : overrides) replaced |= std::string_view(o).substr(0, name.size()) == name;
+        }
+        if (!replaced) merged.emplace_back(current);
+    }
+    merged.insert(merged.end(), overrides.begin(), overrides.end());
+    return merged;
+}
+
+std::vector<char*> pointers(const std::vector<std::string>& strings) {
+    std::vector<char*> out;
+    for (const auto& s : strings) out.push_back(const_cast<char*>(s.c_str()));
+    out.push_back(nullptr);
+    return out;
+}
+
+// Commands that may have to be stopped get a process group of their own,
+// so stopping them also stops whatever they spawned. A foreground command
+// keeps ours, which is the one that owns the terminal.
+bool ownGroup(const CommandExecutor::Options& options) {
+    return !options.foreground && (options.cancel || options.timeoutMs > 0);
+}
+
+bool hasRlimits(const CommandExecutor::Limits& limits) {
+    return limits.cpuSeconds || limits.addressSpace || limits.fileSize || limits.openFiles;
+}
+
+// In a forked child. Only root may raise a hard limit, so a cap above ours
+// is clamped to it.
+void applyRlimits(const CommandExecutor::Limits& limits) {
+    auto lower = [](int resource, rlim_t value, rlim_t grace) {
+        rlimit current;
+        if (value == 0 || getrlimit(resource, &current) != 0) return;
+        rlimit next{std::min(value, current.rlim_max), std::min(value + grace, current.rlim_max)};
+        setrlimit(resource, &next);
+    };
+    lower(RLIMIT_CPU, limits.cpuSeconds, 1);
+    lower(RLIMIT_AS, limits.addressSpace, 0);
+    lower(RLIMIT_FSIZE, limits.fileSize, 0);
+    lower(RLIMIT_NOFILE, limits.openFiles, 0);
+}
+
+// errno is left as write(2) set it
+bool writeControl(const std::string& file, const std::string& value) {
+    int fd = open(file.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = write(fd, value.data(), value.size()) == static_cast<ssize_t>(value.size());
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return ok;
+}
+
+// The group the command groups go under: a cgroup v2 group delegated to
+// us and named by $HARBOUR_CGROUP, e.g. a systemd unit with Delegate=yes.
+// cgroup v2 only hands controllers down from a group with no processes of
+// its own, so it cannot be the group Harbour runs in; Harbour never moves
+// itself to make room. memory and cpu are enabled in its subtree_control
+// once. Returns the group, or "" with why it cannot be used.
+std::string cgroupParent(std::string& error) {
+    static std::mutex mtx;
+    static std::string parent, failure;
+    static bool tried = false;
+    std::lock_guard<std::mutex> lock(mtx);
+    if (tried) {
+        error = failure;
+        return parent;
+    }
+    tried = true;
+    const char* configured = std::getenv("HARBOUR_CGROUP");
+    std::string dir = configured ? configured : "";
+    struct stat info {};
+    if (dir.empty()) {
+        failure = "HARBOUR_CGROUP does not name a delegated cgroup";
+    } else if (stat((dir + "/cgroup.controllers").c_str(), &info) != 0) {
+        failure = dir + " is not a cgroup v2 group";
+    } else if (std::ifstream procs(dir + "/cgroup.procs"); procs.peek() != std::ifstream::traits_type::eof()) {
+        failure = dir + " holds processes, so it cannot hand controllers down";
+    } else {
+        bool enabled = false;
+        for (const char* controller : {"+memory", "+cpu"}) {
+            bool here = writeControl(dir + "/cgroup.subtree_control", controller);
+            if (!here && failure.empty())
+                failure = std::string("cannot enable ") + (controller + 1) + " in " + dir + ": " + std::strerror(errno);
+            enabled |= here;
+        }
+        if (enabled) {
+            parent = dir;
+            failure.clear();
+        }
+    }
+    error = failure;
+    return parent;
+}
+
+// Command groups not yet removed; whatever is left at exit goes then
+std::mutex liveMutex;
+std::set<std::string> liveCgroups;
+
+void removeCgroup(const std::string& dir);
+
+void removeLiveCgroups() {
+    std::set<std::string> left;
+    {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        left = liveCgroups;
+    }
+    for (const auto& dir : left) removeCgroup(dir);
+}
+
+// A cgroup v2 group carrying the memory and CPU caps. Returns its
+// directory, or "" with error when the caps cannot be set.
+std::string makeCgroup(const CommandExecutor::Limits& limits, std::string& error) {
+    static std::atomic<unsigned> made{0};
+    std::string parent = cgroupParent(error);
+    if (parent.empty()) return "";
+    // Named for our pid, since other Harbour processes may share the parent
+    std::string dir = parent + "/harbour-" + std::to_string(getpid()) + "-" + std::to_string(made++);
+    if (mkdir(dir.c_str(), 0755) != 0) {
+        error = "cannot create " + dir + ": " + std::strerror(errno);
+        return "";
+    }
+    {
+        static std::once_flag registered;
+        std::call_once(registered, [] { std::atexit(removeLiveCgroups); });
+        std::lock_guard<std::mutex> lock(liveMutex);
+        liveCgroups.insert(dir);
+    }
+    auto cap = [&](const std::string& file, const std::string& value) {
+        if (writeControl(dir + "/" + file, value)) return true;
+        error = "cannot write " + dir + "/" + file + ": " + std::strerror(errno);
+        return false;
+    };
+    bool ok = true;
+    if (limits.memoryMax) ok = cap("memory.max", std::to_string(limits.memoryMax));
+    if (ok && limits.cpuMax > 0) {
+        long quota = std::max(1000L, static_cast<long>(limits.cpuMax * 100000));
+        ok = cap("cpu.max", std::to_string(quota) + " 100000");
+    }
+    if (!ok) {
+        removeCgroup(dir);
+        return "";
+    }
+    return dir;
+}
+
+// Once the command is reaped; anything it left running goes with the group
+void removeCgroup(const std::string& dir) {
+    {
+        std::lock_guard<std::mutex> lock(liveMutex);
+        liveCgroups.erase(dir);
+    }
+    if (rmdir(dir.c_str()) == 0 || errno != EBUSY) return;
+    writeControl(dir + "/cgroup.kill", "1");
+    for (int i = 0; i < 50 && rmdir(dir.c_str()) != 0 && errno == EBUSY; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
 
-    if (captureOutput) {
-        pipe(outPipe);
-        pipe(errPipe);
+// rchar and wchar, which the kernel keeps until the child is reaped
+void readIo(pid_t pid, CommandExecutor::Result& result) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/io");
+    std::string key;
+    uint64_t value;
+    while (in >> key >> value) {
+        if (key == "rchar:") result.readBytes = value;
+        else if (key == "wchar:") result.writeBytes = value;
     }
+}
+
+double toMs(const timeval& t) {
+    return static_cast<double>(t.tv_sec) * 1e3 + static_cast<double>(t.tv_usec) / 1e3;
+}
 
-    pid = fork();
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int openPidfd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+// Closes every descriptor from `from` up, in a forked child
+void closeFrom(int from) {
+#ifdef SYS_close_range
+    if (syscall(SYS_close_range, from, ~0U, 0) == 0) return;
+#endif
+    for (long fd = from, max = sysconf(_SC_OPEN_MAX); fd < max && fd < 65536; ++fd) close(static_cast<int>(fd));
+}
+
+// The fork() path, kept for work that must happen while the child waits
+// before its exec (onSpawn, joining a cgroup, setting rlimits) and for libcs
+// without posix_spawn_file_actions_addchdir_np
+pid_t forkExec(char* const argv[], char* const envp[], const CommandExecutor::Options& options, const int stdio[3],
+               const std::string& cgroup) {
+    int gate[2] = {-1, -1};
+    bool gated = options.onSpawn || !cgroup.empty();
+    if (gated && pipe2(gate, O_CLOEXEC) != 0) debug::print("pipe() failed; the parent races the exec");
+
+    pid_t pid = fork();
     if (pid == 0) {
-        if (captureOutput) {
-            dup2(outPipe[1], STDOUT_FILENO);
-            dup2(errPipe[1], STDERR_FILENO);
-            close(outPipe[0]); close(outPipe[1]);
-            close(errPipe[0]); close(errPipe[1]);
-        }
-        std::vector<char*> cargs;
-        for (const auto& s : args) cargs.push_back(const_cast<char*>(s.c_str()));
-        cargs.push_back(nullptr);
-        execvp(cargs[0], cargs.data());
+        // Own process group, so cancelling also stops whatever the command spawned
+        if (ownGroup(options)) setpgid(0, 0);
+        if (gate[0] >= 0) {
+            // Held until the parent is done with us and closes its end
+            char c;
+            close(gate[1]);
+            while (read(gate[0], &c, 1) < 0 && errno == EINTR) {}
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (stdio[i] < 0) continue;
+            if (stdio[i] == i) fcntl(i, F_SETFD, 0);
+            else dup2(stdio[i], i);
+        }
+        if (!options.cwd.empty() && chdir(options.cwd.c_str()) != 0) _exit(127);
+        closeFrom(3);
+        applyRlimits(options.limits);
+        execvpe(argv[0], argv, envp);
         _exit(127);
-    } else if (pid > 0) {
-        if (captureOutput) {
+    }
+    if (pid > 0 && ownGroup(options)) setpgid(pid, pid);
+    if (gate[0] >= 0) close(gate[0]);
+    if (pid > 0 && !cgroup.empty() && !writeControl(cgroup + "/cgroup.procs", std::to_string(pid)))
+        debug::print("Cannot move ", pid, " into ", cgroup);
+    if (pid > 0 && options.onSpawn) options.onSpawn(pid);
+    if (gate[1] >= 0) close(gate[1]);
+    return pid;
+}
+
+} // namespace
+
+CommandExecutor::Result CommandExecutor::run(const std::vector<std::string>& args, bool captureOutput) {
+    Options options;
+    options.capture = captureOutput;
+    return run(args, options);
+}
+
+CommandExecutor::Result CommandExecutor::runMerged(const std::vector<std::string>& args) {
+    Options options;
+    options.mergeStderr = true;
+    CommandExecutor exec;
+    return exec.run(args, options);
+}
+
+CommandExecutor::Result CommandExecutor::run(const std::vector<std::string>& args, const Options& options) {
+    Trace::Scope scope(describe(args), "command");
+    bool forwarding = !options.capture && !options.onLine && (!options.teePath.empty() || options.tailBytes > 0);
+    bool piped = options.capture || options.onLine || forwarding;
+    int outPipe[2] = {-1, -1}, errPipe[2] = {-1, -1};
+    int status = -1;
+
+    // Close-on-exec keeps these out of children spawned by other threads
+    if (piped && (pipe2(outPipe, O_CLOEXEC) != 0 || pipe2(errPipe, O_CLOEXEC) != 0)) {
+        for (int fd : {outPipe[0], outPipe[1], errPipe[0], errPipe[1]})
+            if (fd >= 0) close(fd);
+        debug::print("pipe() failed");
+        return Result::failed(127, "pipe() failed");
+    }
+    int logFd = -1;
+    if (forwarding && !options.teePath.empty()) {
+        // No O_APPEND: splice(2) refuses append-mode files
+        logFd = open(options.teePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (logFd < 0) debug::print("Cannot open ", options.teePath, "; output is not logged");
+    }
+
+    int stdio[3] = {-1, -1, -1};
+    if (piped) {
+        stdio[STDOUT_FILENO] = outPipe[1];
+        stdio[STDERR_FILENO] = options.mergeStderr ? outPipe[1] : errPipe[1];
+    }
+    Process process;
+    std::string spawnError;
+    if (!spawn(args, options, stdio, process, spawnError)) {
+        if (piped) {
+            for (int fd : {outPipe[0], outPipe[1], errPipe[0], errPipe[1]}) close(fd);
+        }
+        if (logFd >= 0) close(logFd);
+        debug::print(spawnError);
+        return Result::failed(127, spawnError);
+    }
+    pid_t pid = process.pid;
+    auto started = std::chrono::steady_clock::now();
+
+    bool watched = options.cancel || options.timeoutMs > 0;
+    pid_t target = ownGroup(options) ? -pid : pid;
+    bool cancelled = false, timedOut = false, killed = false;
+    auto stoppedAt = started;
+    // SIGTERM first so tools like git can clean up, SIGKILL if they linger
+    auto checkStop = [&] {
+        auto now = std::chrono::steady_clock::now();
+        if (!cancelled && !timedOut) {
+            cancelled = options.cancel && options.cancel->load();
+            timedOut = !cancelled && options.timeoutMs > 0 && now - started >= std::chrono::milliseconds(options.timeoutMs);
+            if (cancelled || timedOut) {
+                stoppedAt = now;
+                kill(target, SIGTERM);
+            }
+        } else if (!killed && now - stoppedAt >= std::chrono::milliseconds(options.killGraceMs)) {
+            killed = true;
+            kill(target, SIGKILL);
+        }
+    };
+
+    Sink out(Stream::Out, options, options.spillPath.empty() ? "" : options.spillPath + ".stdout");
+    Sink err(Stream::Err, options, options.spillPath.empty() ? "" : options.spillPath + ".stderr");
+    off_t logOffset = 0;
+    Forwarder outForward(STDOUT_FILENO, logFd, logOffset, options.tailBytes);
+    Forwarder errForward(STDERR_FILENO, logFd, logOffset, options.tailBytes);
+    bool forwardTruncated = false;
+    if (piped) {
+        close(outPipe[1]);
+        close(errPipe[1]);
+        // Drain both pipes together; reading one to EOF first deadlocks
+        // once the child fills the other pipe's buffer.
+        pollfd fds[2] = {{outPipe[0], POLLIN, 0}, {errPipe[0], POLLIN, 0}};
+        Sink* sinks[2] = {&out, &err};
+        Forwarder* forwarders[2] = {&outForward, &errForward};
+        int remaining = 2;
+        char buf[65536];
+        while (remaining > 0) {
+            int ready = poll(fds, 2, watched ? 50 : -1);
+            checkStop();
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (int i = 0; i < 2; ++i) {
+                if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+                if (forwarding) {
+                    if (!forwarders[i]->pump(fds[i].fd)) {
+                        close(fds[i].fd);
+                        fds[i].fd = -1;
+                        --remaining;
+                    }
+                    continue;
+                }
+                ssize_t n = read(fds[i].fd, buf, sizeof(buf));
+                if (n > 0) {
+                    sinks[i]->append(buf, static_cast<size_t>(n));
+                } else if (n == 0 || errno != EINTR) {
+                    close(fds[i].fd);
+                    fds[i].fd = -1;
+                    --remaining;
+                }
+            }
+        }
+        for (auto& fd : fds)
+            if (fd.fd >= 0) close(fd.fd);
+        out.finish();
+        err.finish();
+        if (forwarding) {
+            out.captured = outForward.finish(forwardTruncated);
+            err.captured = errForward.finish(forwardTruncated);
+        }
+    }
+    if (logFd >= 0) close(logFd);
+    Result result;
+    if (watched) {
+        while (!reap(process, false, status, result)) {
+            checkStop();
+            // The pidfd wakes us the moment the child exits
+            pollfd exited = {process.pidfd, POLLIN, 0};
+            if (process.pidfd < 0 || poll(&exited, 1, 50) < 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    } else {
+        reap(process, true, status, result);
+    }
+    result.wallMs = msSince(started);
+
+    result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : status;
+    if (result.exitCode != 0) debug::print("Command failed with code ", result.exitCode);
+    if (timedOut) debug::print("Command timed out after ", options.timeoutMs, " ms");
+    result.output = std::move(out.captured);
+    result.error = std::move(err.captured);
+    result.truncated = out.truncated || err.truncated || forwardTruncated;
+    result.cancelled = cancelled;
+    result.timedOut = timedOut;
+    result.outputSpill = out.spilledTo();
+    result.errorSpill = err.spilledTo();
+    scope.arg("wall_ms", result.wallMs);
+    scope.arg("cpu_ms", result.cpuMs);
+    scope.arg("max_rss_kb", static_cast<double>(result.maxRssKb));
+    scope.arg("read_bytes", static_cast<double>(result.readBytes));
+    scope.arg("write_bytes", static_cast<double>(result.writeBytes));
+    return result;
+}
+
+bool CommandExecutor::spawn(const std::vector<std::string>& args, const Options& options, const int stdio[3],
+                            Process& process, std::string& error) {
+    if (args.empty()) {
+        error = "empty command";
+        return false;
+    }
+    std::vector<char*> argv = pointers(args);
+    std::vector<std::string> envStorage;
+    std::vector<char*> envp;
+    char* const* envArg = environ;
+    if (!options.env.empty()) {
+        envStorage = mergedEnvironment(options.env);
+        envp = pointers(envStorage);
+        envArg = envp.data();
+    }
+
+    const Limits& limits = options.limits;
+    if (limits.memoryMax || limits.cpuMax > 0) {
+        std::string why;
+        process.cgroup = makeCgroup(limits, why);
+        if (process.cgroup.empty()) debug::print("Running ", args[0], " without cgroup caps: ", why);
+    }
+    bool useFork = options.onSpawn || hasRlimits(limits) || !process.cgroup.empty();
+#ifndef HARBOUR_SPAWN_CHDIR
+    useFork |= !options.cwd.empty();
+#endif
+    if (useFork) {
+        process.pid = forkExec(argv.data(), envArg, options, stdio, process.cgroup);
+        if (process.pid < 0) {
+            error = std::string("fork() failed: ") + std::strerror(errno);
+            if (!process.cgroup.empty()) removeCgroup(process.cgroup);
+            process.cgroup.clear();
+            return false;
+        }
+        process.pidfd = openPidfd(process.pid);
+        return true;
+    }
+
+    // posix_spawn shares our address space until the exec (CLONE_VFORK in
+    // glibc), so nothing is copied however large the parent has grown
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+    for (int i = 0; i < 3; ++i)
+        if (stdio[i] >= 0) posix_spawn_file_actions_adddup2(&actions, stdio[i], i);
+#ifdef HARBOUR_SPAWN_CHDIR
+    if (!options.cwd.empty()) posix_spawn_file_actions_addchdir_np(&actions, options.cwd.c_str());
+#endif
+#ifdef HARBOUR_SPAWN_CLOSEFROM
+    // close_range(2) in the child, for descriptors opened without O_CLOEXEC
+    posix_spawn_file_actions_addclosefrom_np(&actions, 3);
+#endif
+    if (ownGroup(options)) {
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attr, 0);
+    }
+    int rc = posix_spawnp(&process.pid, argv[0], &actions, &attr, argv.data(), envArg);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (rc != 0) {
+        error = args[0] + ": " + std::strerror(rc);
+        return false;
+    }
+    process.pidfd = openPidfd(process.pid);
+    return true;
+}
+
+bool CommandExecutor::reap(Process& process, bool wait, int& status, Result& result) {
+    // Wait without reaping first: /proc/<pid>/io goes with the zombie
+    siginfo_t info{};
+    int rc;
+    while ((rc = waitid(P_PID, process.pid, &info, WEXITED | WNOWAIT | (wait ? 0 : WNOHANG))) < 0 && errno == EINTR) {}
+    if (rc == 0 && info.si_pid == 0) return false;
+    readIo(process.pid, result);
+    while (wait4(process.pid, &status, 0, &result.usage) < 0 && errno == EINTR) {}
+    result.cpuMs = toMs(result.usage.ru_utime) + toMs(result.usage.ru_stime);
+    result.maxRssKb = result.usage.ru_maxrss;
+    if (process.pidfd >= 0) close(process.pidfd);
+    process.pidfd = -1;
+    if (!process.cgroup.empty()) removeCgroup(process.cgroup);
+    process.cgroup.clear();
+    return true;
+}
+
+struct ProcessPool::Loop {
+    struct Job {
+        std::vector<std::string> args;
+        CommandExecutor::Options options;
+        Callback done;
+        const std::atomic<bool>* userCancel = nullptr;
+        std::atomic<bool> poolCancel{false};
+        CommandExecutor::Process process;
+        int fds[2] = {-1, -1};  // stdout and stderr read ends
+        std::unique_ptr<Sink> sinks[2];
+        bool exited = false;
+        int status = 0;
+        CommandExecutor::Result result;  // the cost, once reaped
+        bool terminating = false;
+        bool timedOut = false;
+        bool killed = false;
+        std::chrono::steady_clock::time_point startedAt;
+        std::chrono::steady_clock::time_point terminatedAt;
+    };
+
+    // epoll tags: the wake eventfd is 0, otherwise (job id << 2) | kind
+    enum Kind : uint64_t { OUT = 0, ERR = 1, EXIT = 2 };
+
+    unsigned maxRunning;
+    int epfd = -1;
+    int wake = -1;
+    std::mutex mtx;
+    std::condition_variable idle;
+    std::deque<std::unique_ptr<Job>> queued;   // under mtx
+    size_t pending = 0;                        // queued + running, under mtx
+    bool stopping = false;                     // under mtx
+    bool cancelRequested = false;              // under mtx
+    std::map<uint64_t, std::unique_ptr<Job>> running;  // event thread only
+    uint64_t nextId = 1;
+    std::thread thread;
+
+    explicit Loop(unsigned maxRunning) : maxRunning(maxRunning ? maxRunning : Sys::usableCores()) {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        watch(wake, 0);
+        thread = std::thread([this] { serve(); });
+    }
+
+    ~Loop() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        notify();
+        thread.join();
+        close(wake);
+        close(epfd);
+    }
+
+    void notify() {
+        uint64_t one = 1;
+        if (write(wake, &one, sizeof(one)) < 0) debug::print("eventfd write failed");
+    }
+
+    void watch(int fd, uint64_t tag) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = tag;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void unwatch(int& fd) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        fd = -1;
+    }
+
+    void finish(Job& job, CommandExecutor::Result result) {
+        job.done(std::move(result));
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pending == 0) idle.notify_all();
+    }
+
+    void start(uint64_t id, std::unique_ptr<Job> job) {
+        auto& options = job->options;
+        // Always a process group of its own, so a cancel reaches its children
+        job->userCancel = options.cancel;
+        options.cancel = &job->poolCancel;
+        options.foreground = false;
+        options.teePath.clear();
+        options.tailBytes = 0;
+        bool piped = options.capture || options.onLine;
+        int outPipe[2] = {-1, -1}, errPipe[2] = {-1, -1};
+        if (piped && (pipe2(outPipe, O_CLOEXEC) != 0 || pipe2(errPipe, O_CLOEXEC) != 0)) {
+            for (int fd : {outPipe[0], outPipe[1], errPipe[0], errPipe[1]})
+                if (fd >= 0) close(fd);
+            finish(*job, CommandExecutor::Result::failed(127, "pipe() failed"));
+            return;
+        }
+        int stdio[3] = {-1, -1, -1};
+        if (piped) {
+            stdio[STDOUT_FILENO] = outPipe[1];
+            stdio[STDERR_FILENO] = options.mergeStderr ? outPipe[1] : errPipe[1];
+        }
+        CommandExecutor::Process process;
+        std::string error;
+        bool started = CommandExecutor::spawn(job->args, options, stdio, process, error);
+        if (piped) {
             close(outPipe[1]);
             close(errPipe[1]);
-            char buf[4096];
-            ssize_t n;
-            while ((n = read(outPipe[0], buf, sizeof(buf))) > 0) outStream.write(buf, n);
-            while ((n = read(errPipe[0], buf, sizeof(buf))) > 0) errStream.write(buf, n);
-            close(outPipe[0]);
-            close(errPipe[0]);
-        }
-        waitpid(pid, &status, 0);
-    } else {
-        debug::print("fork() failed");
-        return {127, "", "fork() failed"};
+        }
+        if (!started) {
+            if (piped) {
+                close(outPipe[0]);
+                close(errPipe[0]);
+            }
+            finish(*job, CommandExecutor::Result::failed(127, error));
+            return;
+        }
+        job->process = process;
+        job->startedAt = std::chrono::steady_clock::now();
+        if (process.pidfd >= 0) watch(process.pidfd, id << 2 | EXIT);
+        if (piped) {
+            job->fds[0] = outPipe[0];
+            job->fds[1] = errPipe[0];
+            for (int i = 0; i < 2; ++i) watch(job->fds[i], id << 2 | (i == 0 ? OUT : ERR));
+        }
+        const std::string& spill = options.spillPath;
+        job->sinks[0] = std::make_unique<Sink>(CommandExecutor::Stream::Out, options,
+                                               spill.empty() ? "" : spill + ".stdout");
+        job->sinks[1] = std::make_unique<Sink>(CommandExecutor::Stream::Err, options,
+                                               spill.empty() ? "" : spill + ".stderr");
+        running.emplace(id, std::move(job));
     }
-    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : status;
-    if (exitCode != 0) debug::print("Command failed with code ", exitCode);
-    return {exitCode, outStream.str(), errStream.str()};
+
+    void reap(Job& job) {
+        // Closing the pidfd also drops it from the epoll set
+        if (job.exited || !CommandExecutor::reap(job.process, false, job.status, job.result)) return;
+        job.exited = true;
+        job.result.wallMs = msSince(job.startedAt);
+    }
+
+    // SIGTERM first so tools like git can clean up, SIGKILL if they linger.
+    // A reaped child may have left descendants holding the pipes open, so
+    // the group is signalled until both are closed too; the group id cannot
+    // be reused while any of them is alive.
+    void checkStop(Job& job) {
+        if (job.exited && job.fds[0] < 0 && job.fds[1] < 0) return;
+        auto now = std::chrono::steady_clock::now();
+        const auto& options = job.options;
+        if (!job.terminating) {
+            bool requested = job.poolCancel || (job.userCancel && job.userCancel->load());
+            job.timedOut = !requested && options.timeoutMs > 0 &&
+                           now - job.startedAt >= std::chrono::milliseconds(options.timeoutMs);
+            if (requested || job.timedOut) {
+                job.terminating = true;
+                job.terminatedAt = now;
+                kill(-job.process.pid, SIGTERM);
+            }
+        } else if (!job.killed && now - job.terminatedAt >= std::chrono::milliseconds(options.killGraceMs)) {
+            job.killed = true;
+            kill(-job.process.pid, SIGKILL);
+        }
+    }
+
+    void complete(Job& job) {
+        for (auto& sink : job.sinks) sink->finish();
+        CommandExecutor::Result result = std::move(job.result);
+        result.exitCode = WIFEXITED(job.status) ? WEXITSTATUS(job.status) : job.status;
+        result.output = std::move(job.sinks[0]->captured);
+        result.error = std::move(job.sinks[1]->captured);
+        result.truncated = job.sinks[0]->truncated || job.sinks[1]->truncated;
+        result.outputSpill = job.sinks[0]->spilledTo();
+        result.errorSpill = job.sinks[1]->spilledTo();
+        result.timedOut = job.timedOut;
+        result.cancelled = job.terminating && !job.timedOut;
+        finish(job, std::move(result));
+    }
+
+    void serve() {
+        epoll_event events[64];
+        char buf[65536];
+        while (true) {
+            std::vector<std::unique_ptr<Job>> toStart, dropped;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (cancelRequested) {
+                    cancelRequested = false;
+                    for (auto& job : queued) dropped.push_back(std::move(job));
+                    queued.clear();
+                    for (auto& [id, job] : running) job->poolCancel = true;
+                }
+                while (running.size() + toStart.size() < maxRunning && !queued.empty()) {
+                    toStart.push_back(std::move(queued.front()));
+                    queued.pop_front();
+                }
+                if (stopping && pending == 0) break;
+            }
+            for (auto& job : dropped) {
+                auto result = CommandExecutor::Result::failed(-1, "cancelled");
+                result.cancelled = true;
+                finish(*job, std::move(result));
+            }
+            for (auto& job : toStart) start(nextId++, std::move(job));
+
+            // Only cancellation, timeouts and kernels without pidfds need a timer
+            bool ticking = false;
+            for (auto& [id, job] : running)
+                ticking |= job->userCancel || job->terminating || job->poolCancel || job->options.timeoutMs > 0 ||
+                           (job->process.pidfd < 0 && !job->exited);
+            int ready = epoll_wait(epfd, events, 64, ticking ? 50 : -1);
+            for (int i = 0; i < ready; ++i) {
+                uint64_t tag = events[i].data.u64;
+                if (tag == 0) {
+                    uint64_t count;
+                    while (read(wake, &count, sizeof(count)) > 0) {}
+                    continue;
+                }
+                auto it = running.find(tag >> 2);
+                if (it == running.end()) continue;
+                Job& job = *it->second;
+                uint64_t kind = tag & 3;
+                if (kind == EXIT) {
+                    reap(job);
+                    continue;
+                }
+                int& fd = job.fds[kind];
+                ssize_t n = read(fd, buf, sizeof(buf));
+                if (n > 0) job.sinks[kind]->append(buf, static_cast<size_t>(n));
+                else if (n == 0 || (errno != EINTR && errno != EAGAIN)) unwatch(fd);
+            }
+            for (auto it = running.begin(); it != running.end();) {
+                Job& job = *it->second;
+                checkStop(job);
+                if (job.process.pidfd < 0) reap(job);
+                if (job.exited && job.fds[0] < 0 && job.fds[1] < 0) {
+                    auto done = std::move(it->second);
+                    it = running.erase(it);
+                    complete(*done);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+};
+
+ProcessPool::ProcessPool(unsigned maxRunning) : loop(std::make_unique<Loop>(maxRunning)) {}
+
+ProcessPool::~ProcessPool() = default;
+
+void ProcessPool::submit(std::vector<std::string> args, CommandExecutor::Options options, Callback done) {
+    auto job = std::make_unique<Loop::Job>();
+    job->args = std::move(args);
+    job->options = std::move(options);
+    job->done = std::move(done);
+    {
+        std::lock_guard<std::mutex> lock(loop->mtx);
+        loop->queued.push_back(std::move(job));
+        ++loop->pending;
+    }
+    loop->notify();
+}
+
+std::future<CommandExecutor::Result> ProcessPool::submit(std::vector<std::string> args,
+                                                         CommandExecutor::Options options) {
+    auto promise = std::make_shared<std::promise<CommandExecutor::Result>>();
+    auto future = promise->get_future();
+    submit(std::move(args), std::move(options),
+           [promise](CommandExecutor::Result result) { promise->set_value(std::move(result)); });
+    return future;
+}
+
+void ProcessPool::cancelAll() {
+    {
+        std::lock_guard<std::mutex> lock(loop->mtx);
+        loop->cancelRequested = true;
+    }
+    loop->notify();
+}
+
+void ProcessPool::wait() {
+    std::unique_lock<std::mutex> lock(loop->mtx);
+    loop->idle.wait(lock, [&] { return loop->pending == 0; });
 }
 
 } // namespace Harbour 
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "harbour.hpp"
+#include "CompileCache.hpp"
+#include "hash.hpp"
+#include "sysinfo.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* BASE_PLACEHOLDER = "@HARBOUR_BASE@";
+const char* TARGET_PLACEHOLDER = "@HARBOUR_TARGET@";
+
+// Options whose value is the following argument
+bool takesValue(const std::string& arg) {
+    static const char* opts[] = {"-o", "-MF", "-MT", "-MQ", "-I", "-D", "-U", "-include",
+                                 "-imacros", "-isystem", "-iquote", "-idirafter", "-x",
+                                 "-Xclang", "-arch", "-target", "--param", "-isysroot"};
+    for (const char* opt : opts)
+        if (arg == opt) return true;
+    return false;
+}
+
+bool isSource(const std::string& arg) {
+    static const char* exts[] = {".c", ".cc", ".cpp", ".cxx", ".c++", ".C"};
+    for (const char* ext : exts) {
+        std::string e = ext;
+        if (arg.size() > e.size() && arg.compare(arg.size() - e.size(), e.size(), e) == 0) return true;
+    }
+    return false;
+}
+
+std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+    if (from.empty()) return text;
+    size_t pos = 0;
+    while ((pos = text.find(from, pos)) != std::string::npos) {
+        text.replace(pos, from.size(), to);
+        pos += to.size();
+    }
+    return text;
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// Writes via a temporary file and rename so concurrent readers never see a
+// partial entry.
+bool writeAtomic(const fs::path& path, const std::string& data) {
+    fs::path tmp = FH::tempSibling(path);
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out.write(data.data(), data.size())) return false;
+    }
+    std::error_code ec;
+    return FH::publish(tmp, path, ec);
+}
+
+long long parseSize(const std::string& value) {
+    if (value.empty()) return 0;
+    long long n = std::atoll(value.c_str());
+    switch (value.back()) {
+    case 'k': case 'K': return n << 10;
+    case 'm': case 'M': return n << 20;
+    case 'g': case 'G': return n << 30;
+    default: return n;
+    }
+}
+
+} // namespace
+
+CompileCache::CompileCache(const std::string& dir) : dir(dir.empty() ? defaultDir() : dir) {
+    const char* max = std::getenv("HARBOUR_CACHE_MAXSIZE");
+    maxSize = max ? parseSize(max) : 0;
+    if (maxSize <= 0) maxSize = 5LL << 30;
+}
+
+std::string CompileCache::defaultDir() {
+    if (const char* dir = std::getenv("HARBOUR_CACHE_DIR")) return dir;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::string(xdg) + "/harbour";
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.cache/harbour";
+    return "/tmp/harbour-cache";
+}
+
+const std::string& CompileCache::getDir() const { return dir; }
+
+int CompileCache::exec(const std::string& baseDir, const std::vector<std::string>& compilerArgs) {
+    if (compilerArgs.empty()) return 127;
+    CommandExecutor exec;
+
+    // Work out what kind of compile this is; anything we do not understand
+    // is passed straight through.
+    bool compileOnly = false, cacheable = true, writesDepfile = false;
+    std::string output, source, depfile, depTarget;
+    std::vector<std::string> cppArgs;   // preprocessor invocation, without outputs
+    for (size_t i = 0; i < compilerArgs.size(); ++i) {
+        const std::string& arg = compilerArgs[i];
+        bool hasValue = i > 0 && takesValue(arg) && i + 1 < compilerArgs.size();
+        const std::string value = hasValue ? compilerArgs[i + 1] : "";
+        if (arg == "-c") {
+            compileOnly = true;
+            continue;
+        } else if (arg == "-o" && hasValue) {
+            output = value;
+        } else if ((arg == "-MF" || arg == "-MT" || arg == "-MQ") && hasValue) {
+            if (arg == "-MF") depfile = value;
+            else depTarget = value;
+        } else if (arg == "-MD" || arg == "-MMD") {
+            writesDepfile = true;
+            continue;
+        } else if (arg == "-MP") {
+            continue;
+        } else if (arg == "-E" || arg == "-S" || arg == "-M" || arg == "-MM" || arg == "-" ||
+                   arg.rfind("-ftime-trace", 0) == 0 || arg.rfind("-fprofile", 0) == 0 ||
+                   arg.rfind("--save-temps", 0) == 0 || arg.rfind("-save-temps", 0) == 0) {
+            cacheable = false;
+        } else if (i > 0 && !hasValue && arg[0] != '-' && isSource(arg)) {
+            if (!source.empty()) cacheable = false;
+            source = arg;
+        }
+        if (hasValue) {
+            if (arg != "-o" && arg != "-MF" && arg != "-MT" && arg != "-MQ") {
+                cppArgs.push_back(arg);
+                cppArgs.push_back(value);
+            }
+            ++i;
+            continue;
+        }
+        cppArgs.push_back(arg);
+    }
+    if (!compileOnly || output.empty() || source.empty()) cacheable = false;
+    if (writesDepfile && depfile.empty()) depfile = fs::path(output).replace_extension(".d").string();
+    if (writesDepfile && depTarget.empty()) depTarget = output;
+
+    if (!cacheable) {
+        updateStats({0, 0, 1});
+        return exec.run(compilerArgs, false).exitCode;
+    }
+
+    std::error_code ec;
+    std::string base = baseDir.empty() ? "" : fs::weakly_canonical(baseDir, ec).string();
+    auto remap = [&](const std::string& text) { return replaceAll(text, base, BASE_PLACEHOLDER); };
+
+    cppArgs.push_back("-E");
+    auto pre = exec.run(cppArgs, true);
+    if (pre.exitCode != 0) {
+        // Let the real compile report the error
+        updateStats({0, 0, 1});
+        return exec.run(compilerArgs, false).exitCode;
+    }
+
+    Hash::Hasher hasher;
+    hasher.update("harbour-compile-cache-v1");
+    std::string compiler = compilerArgs[0];
+    if (compiler.find('/') == std::string::npos) compiler = Sys::findProgram(compiler);
+    fs::path compilerPath = fs::canonical(compiler, ec);
+    hasher.update(compilerPath.string());
+    if (!ec) {
+        hasher.update(static_cast<long long>(fs::file_size(compilerPath, ec)));
+        hasher.update(static_cast<long long>(fs::last_write_time(compilerPath, ec).time_since_epoch().count()));
+    }
+    hasher.update(remap(fs::current_path(ec).string()));
+    for (const auto& arg : cppArgs) hasher.update(remap(arg));
+    hasher.update(remap(pre.output));
+    std::string key = hasher.hex();
+
+    fs::path entryDir = fs::path(dir) / "objects" / key.substr(0, 2);
+    fs::path objEntry = entryDir / (key + ".o");
+    fs::path depEntry = entryDir / (key + ".d");
+    fs::path logEntry = entryDir / (key + ".stderr");
+    fs::path metaEntry = entryDir / (key + ".meta");
+
+    if (fs::exists(objEntry) && (!writesDepfile || fs::exists(depEntry))) {
+        fs::copy_file(objEntry, output, fs::copy_options::overwrite_existing, ec);
+        if (!ec && writesDepfile) {
+            std::string deps = readFile(depEntry);
+            deps = replaceAll(replaceAll(deps, TARGET_PLACEHOLDER, depTarget), BASE_PLACEHOLDER, base);
+            ec = writeAtomic(depfile, deps) ? std::error_code() : std::make_error_code(std::errc::io_error);
+        }
+        if (!ec) {
+            // Mark as recently used for LRU eviction
+            fs::last_write_time(objEntry, fs::file_time_type::clock::now(), ec);
+            std::cerr << readFile(logEntry);
+            long long savedMs = std::atoll(readFile(metaEntry).c_str());
+            updateStats({1, 0, 0, 0, savedMs});
+            return 0;
+        }
+        debug::print("Cache hit for ", key, " could not be restored, recompiling");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = CommandExecutor::runMerged(compilerArgs);
+    long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - start).count();
+    std::cerr << result.output;
+    if (result.exitCode != 0 || !fs::exists(output)) {
+        updateStats({0, 1, 0, elapsedMs});
+        return result.exitCode;
+    }
+
+    fs::create_directories(entryDir, ec);
+    Stats delta{0, 1, 0, elapsedMs};
+    bool stored = writeAtomic(metaEntry, std::to_string(elapsedMs)) && writeAtomic(logEntry, result.output);
+    if (stored && writesDepfile) {
+        std::string deps = readFile(depfile);
+        if (!depTarget.empty()) deps = replaceAll(deps, depTarget, TARGET_PLACEHOLDER);
+        stored = writeAtomic(depEntry, remap(deps));
+    }
+    // The object goes in last: its presence is what marks an entry complete
+    if (stored) stored = writeAtomic(objEntry, readFile(output));
+    if (stored) {
+        delta.entries = 1;
+        for (const auto& p : {objEntry, depEntry, logEntry, metaEntry}) {
+            auto size = fs::file_size(p, ec);
+            if (!ec) delta.sizeBytes += static_cast<long long>(size);
+        }
+    }
+    updateStats(delta);
+    if (stats().sizeBytes > maxSize) evict();
+    return 0;
+}
+
+CompileCache::Stats CompileCache::stats() const {
+    Stats s;
+    std::ifstream in(dir + "/stats");
+    std::string line;
+    while (std::getline(in, line)) {
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        long long value = std::atoll(line.c_str() + eq + 1);
+        if (key == "hits") s.hits = value;
+        else if (key == "misses") s.misses = value;
+        else if (key == "uncacheable") s.uncacheable = value;
+        else if (key == "compile_ms") s.compileMs = value;
+        else if (key == "saved_ms") s.savedMs = value;
+        else if (key == "size_bytes") s.sizeBytes = value;
+        else if (key == "entries") s.entries = value;
+    }
+    return s;
+}
+
+void CompileCache::saveStats(const Stats& s) {
+    std::ostringstream out;
+    out << "hits=" << s.hits << "\n"
+        << "misses=" << s.misses << "\n"
+        << "uncacheable=" << s.uncacheable << "\n"
+        << "compile_ms=" << s.compileMs << "\n"
+        << "saved_ms=" << s.savedMs << "\n"
+        << "size_bytes=" << s.sizeBytes << "\n"
+        << "entries=" << s.entries << "\n";
+    writeAtomic(dir + "/stats", out.str());
+}
+
+void CompileCache::updateStats(const Stats& delta) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    FH::FileLock lock(dir + "/lock");
+    Stats s = stats();
+    s.hits += delta.hits;
+    s.misses += delta.misses;
+    s.uncacheable += delta.uncacheable;
+    s.compileMs += delta.compileMs;
+    s.savedMs += delta.savedMs;
+    s.sizeBytes += delta.sizeBytes;
+    s.entries += delta.entries;
+    saveStats(s);
+}
+
+void CompileCache::evict() {
+    struct Entry {
+        fs::path dir;
+        fs::file_time_type used = fs::file_time_type::min();
+        long long size = 0;
+    };
+    std::error_code ec;
+    FH::FileLock lock(dir + "/lock");
+    std::map<std::string, Entry> byKey;
+    long long total = 0;
+    for (const auto& file : fs::recursive_directory_iterator(dir + "/objects", ec)) {
+        if (!file.is_regular_file(ec)) continue;
+        auto path = file.path();
+        long long size = static_cast<long long>(file.file_size(ec));
+        total += size;
+        Entry& entry = byKey[path.stem().string()];
+        entry.dir = path.parent_path();
+        entry.size += size;
+        if (path.extension() == ".o") entry.used = file.last_write_time(ec);
+    }
+    std::vector<std::pair<std::string, Entry>> entries(byKey.begin(), byKey.end());
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.second.used < b.second.used; });
+
+    long long target = maxSize / 10 * 9;
+    long long removed = 0, removedEntries = 0;
+    for (const auto& [key, e] : entries) {
+        if (total - removed <= target) break;
+        for (const char* ext : {".o", ".d", ".stderr", ".meta"})
+            fs::remove(e.dir / (key + ext), ec);
+        removed += e.size;
+        ++removedEntries;
+    }
+    debug::print("Compile cache evicted ", removedEntries, " entries (", removed, " bytes)");
+
+    // Rebase the running totals on what is actually on disk
+    Stats s = stats();
+    s.sizeBytes = total - removed;
+    s.entries = static_cast<long long>(entries.size()) - removedEntries;
+    saveStats(s);
+}
+
+bool CompileCache::clear() {
+    std::error_code ec;
+    FH::FileLock lock(dir + "/lock");
+    fs::remove_all(dir + "/objects", ec);
+    fs::remove(dir + "/stats", ec);
+    return !ec;
+}
+
+void CompileCache::printStats() const {
+    Stats s = stats();
+    long long lookups = s.hits + s.misses;
+    double hitRate = lookups ? 100.0 * s.hits / lookups : 0.0;
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_YELLOW << "Compile cache: " << dir << COLOR_RESET << std::endl;
+    std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::cout << "  hits:           " << s.hits << "\n";
+    std::cout << "  misses:         " << s.misses << "\n";
+    std::cout << "  uncacheable:    " << s.uncacheable << "\n";
+    std::cout << "  hit rate:       " << std::fixed << std::setprecision(1) << hitRate << "%\n";
+    std::cout << "  compile time:   " << s.compileMs / 1000.0 << " s\n";
+    std::cout << "  saved time:     " << s.savedMs / 1000.0 << " s\n";
+    std::cout << "  entries:        " << s.entries << "\n";
+    std::cout << "  size:           " << s.sizeBytes / (1024.0 * 1024.0) << " MiB of "
+              << maxSize / (1024.0 * 1024.0) << " MiB\n";
+}
+
+} // namespace Project
+} // namespace Harbour
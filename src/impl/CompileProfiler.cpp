@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "harbour.hpp"
+#include "json.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* RECORD_EXT = ".harbour-profile";
+
+bool isSource(const std::string& arg) {
+    static const char* exts[] = {".c", ".cc", ".cpp", ".cxx", ".c++", ".C"};
+    for (const char* ext : exts) {
+        std::string e = ext;
+        if (arg.size() > e.size() && arg.compare(arg.size() - e.size(), e.size(), e) == 0) return true;
+    }
+    return false;
+}
+
+std::string trim(const std::string& s) {
+    auto start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    return s.substr(start, s.find_last_not_of(" \t") - start + 1);
+}
+
+std::string shorten(const std::string& name, size_t width) {
+    if (name.size() <= width) return name;
+    return "..." + name.substr(name.size() - (width - 3));
+}
+
+// Splits GCC's -ftime-report table out of the compiler output. Returns the
+// wall time in milliseconds per timer; `rest` keeps everything else.
+std::vector<std::pair<std::string, double>> splitTimeReport(const std::string& output, std::string& rest) {
+    std::vector<std::pair<std::string, double>> timers;
+    std::istringstream in(output);
+    std::string line;
+    bool inReport = false;
+    while (std::getline(in, line)) {
+        if (!inReport && line.rfind("Time variable", 0) == 0) {
+            inReport = true;
+            continue;
+        }
+        if (!inReport) {
+            if (!(line.empty() && rest.empty())) rest += line + "\n";
+            continue;
+        }
+        auto colon = line.find(':');
+        std::string name = trim(line.substr(0, colon));
+        if (colon == std::string::npos || name.empty()) continue;
+        if (name == "TOTAL") {
+            inReport = false;
+            continue;
+        }
+        if (name[0] == '|') continue;  // nested breakdowns of the phase above
+        // usr ( x%) sys ( x%) wall ( x%) GGC ( x%): the third plain number is wall
+        std::istringstream fields(line.substr(colon + 1));
+        std::string field;
+        int column = 0;
+        while (fields >> field) {
+            if (field.find_first_of("()%") != std::string::npos) continue;
+            if (++column == 3) {
+                timers.emplace_back(name, std::atof(field.c_str()) * 1000.0);
+                break;
+            }
+        }
+    }
+    return timers;
+}
+
+} // namespace
+
+std::string CompileProfiler::timeFlag() {
+    const char* cxx = std::getenv("CXX");
+    CommandExecutor exec;
+    auto result = exec.run({cxx && *cxx ? cxx : "c++", "--version"}, true);
+    return result.output.find("clang") != std::string::npos ? "-ftime-trace" : "-ftime-report";
+}
+
+int CompileProfiler::exec(const std::string& flag, const std::vector<std::string>& compilerArgs) {
+    if (compilerArgs.empty()) return 127;
+    bool compileOnly = false;
+    std::string output, source;
+    for (size_t i = 1; i < compilerArgs.size(); ++i) {
+        const std::string& arg = compilerArgs[i];
+        if (arg == "-c") compileOnly = true;
+        else if (arg == "-o" && i + 1 < compilerArgs.size()) output = compilerArgs[++i];
+        else if (arg[0] != '-' && isSource(arg)) source = arg;
+    }
+    if (!compileOnly || output.empty() || source.empty()) {
+        CommandExecutor exec;
+        return exec.run(compilerArgs, false).exitCode;
+    }
+
+    std::vector<std::string> args = compilerArgs;
+    if (!flag.empty()) args.push_back(flag);
+    auto start = std::chrono::steady_clock::now();
+    auto result = CommandExecutor::runMerged(args);
+    auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::string diagnostics;
+    auto timers = splitTimeReport(result.output, diagnostics);
+    std::cerr << diagnostics;
+    if (result.exitCode != 0) return result.exitCode;
+
+    std::ofstream record(output + RECORD_EXT);
+    record << "source=" << fs::absolute(source).lexically_normal().string() << "\n";
+    record << "object=" << output << "\n";
+    record << "wall_ms=" << wallMs << "\n";
+    if (flag == "-ftime-trace")
+        record << "trace=" << fs::path(output).replace_extension(".json").string() << "\n";
+    for (const auto& [name, ms] : timers) record << "phase." << name << "=" << ms << "\n";
+    return 0;
+}
+
+void CompileProfiler::reset(const std::string& buildPath) {
+    std::error_code ec;
+    std::vector<fs::path> stale;
+    for (const auto& entry : fs::recursive_directory_iterator(buildPath, ec))
+        if (entry.path().extension() == RECORD_EXT) stale.push_back(entry.path());
+    for (const auto& path : stale) fs::remove(path, ec);
+}
+
+bool CompileProfiler::collect(const std::string& buildPath) {
+    units.clear();
+    headerTimes.clear();
+    templateTimes.clear();
+    phaseTimes.clear();
+    std::error_code ec;
+    std::vector<fs::path> records;
+    for (const auto& entry : fs::recursive_directory_iterator(buildPath, ec))
+        if (entry.path().extension() == RECORD_EXT) records.push_back(entry.path());
+    std::sort(records.begin(), records.end());
+
+    for (const auto& path : records) {
+        std::ifstream in(path);
+        std::string line;
+        Unit unit;
+        while (std::getline(in, line)) {
+            auto eq = line.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = line.substr(0, eq), value = line.substr(eq + 1);
+            if (key == "source") unit.source = value;
+            else if (key == "object") unit.object = value;
+            else if (key == "wall_ms") unit.wallMs = std::atoll(value.c_str());
+            else if (key == "trace") readTrace(value);
+            else if (key.rfind("phase.", 0) == 0) {
+                auto& entry = phaseTimes[key.substr(6)];
+                entry.name = key.substr(6);
+                entry.ms += std::atof(value.c_str());
+                ++entry.count;
+            }
+        }
+        units.push_back(unit);
+    }
+    std::stable_sort(units.begin(), units.end(), [](const Unit& a, const Unit& b) { return a.wallMs > b.wallMs; });
+    return !units.empty();
+}
+
+void CompileProfiler::readTrace(const std::string& tracePath) {
+    std::ifstream in(tracePath, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    Json::Value root;
+    std::string error;
+    if (!Json::parse(text, root, &error)) {
+        debug::print("Skipping unreadable time trace ", tracePath, ": ", error);
+        return;
+    }
+    const Json::Value* events = root.find("traceEvents");
+    if (!events || !events->isArray()) return;
+    for (const auto& event : events->items) {
+        const Json::Value* dur = event.find("dur");
+        const Json::Value* args = event.find("args");
+        if (event.get("ph") != "X" || !dur || !args) continue;
+        std::string name = event.get("name");
+        std::map<std::string, Entry>* bucket = nullptr;
+        if (name == "Source") bucket = &headerTimes;
+        else if (name == "InstantiateClass" || name == "InstantiateFunction") bucket = &templateTimes;
+        if (!bucket) continue;
+        std::string detail = args->get("detail");
+        if (detail.empty()) continue;
+        auto& entry = (*bucket)[detail];
+        entry.name = detail;
+        entry.ms += dur->number / 1000.0;
+        ++entry.count;
+    }
+}
+
+std::vector<CompileProfiler::Entry> CompileProfiler::ranked(const std::map<std::string, Entry>& times) {
+    std::vector<Entry> entries;
+    for (const auto& [name, entry] : times) entries.push_back(entry);
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.ms > b.ms; });
+    return entries;
+}
+
+std::vector<CompileProfiler::Unit> CompileProfiler::overBudget(long long budgetMs) const {
+    std::vector<Unit> over;
+    if (budgetMs <= 0) return over;
+    for (const auto& unit : units)
+        if (unit.wallMs > budgetMs) over.push_back(unit);
+    return over;
+}
+
+void CompileProfiler::report(std::ostream& out, size_t top) const {
+    auto section = [&](const std::string& title, const std::vector<Entry>& entries) {
+        if (entries.empty()) return;
+        out << COLOR_YELLOW << title << COLOR_RESET << std::endl;
+        for (size_t i = 0; i < entries.size() && i < top; ++i) {
+            out << "  " << std::left << std::setw(60) << shorten(entries[i].name, 60) << std::right << std::fixed
+                << std::setprecision(1) << std::setw(10) << entries[i].ms << " ms";
+            if (entries[i].count > 1) out << "  (x" << entries[i].count << ")";
+            out << std::endl;
+        }
+    };
+
+    out << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    out << COLOR_YELLOW << "Compile profile (" << units.size() << " translation units)" << COLOR_RESET << std::endl;
+    out << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    std::vector<Entry> slowest;
+    for (const auto& unit : units) slowest.push_back({unit.source, static_cast<double>(unit.wallMs), 1});
+    section("Slowest translation units", slowest);
+    section("Most expensive headers (inclusive parse time)", headers());
+    section("Most expensive template instantiations", templates());
+    section("Compiler phases (GCC -ftime-report, summed over TUs)", phases());
+}
+
+} // namespace Project
+} // namespace Harbour
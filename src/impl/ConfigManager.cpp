@@ -1,5 +1,9 @@
+#include <climits>
+#include <filesystem>
 #include <iostream>
+#include <type_traits>
 #include "harbour.hpp"
+#include "numbers.hpp"
 
 namespace Harbour {
 namespace Project {
@@ -12,6 +16,18 @@ bool ConfigManager::readConfig(const std::string& path) {
     }
     std::string line;
     auto& stream = infile.getStream();
+    bool valid = true;
+    // A bad number names its key instead of throwing out of the parse
+    auto integer = [&](const std::string& key, const std::string& value, long long min, long long max, auto& out) {
+        long long parsed = 0;
+        if (Numbers::parseInteger(value, min, max, parsed)) {
+            out = static_cast<std::remove_reference_t<decltype(out)>>(parsed);
+            return;
+        }
+        std::cerr << COLOR_RED << "Invalid value for " << key << " in .harbourConfig: " << value << COLOR_RESET
+                  << std::endl;
+        valid = false;
+    };
     while (std::getline(stream, line)) {
         auto eq = line.find('=');
         if (eq == std::string::npos) continue;
@@ -19,14 +35,44 @@ bool ConfigManager::readConfig(const std::string& path) {
         std::string value = line.substr(eq + 1);
         if (!value.empty() && value.front() == '"') value = value.substr(1, value.size() - 2);
         if (key == "project_name") projectName = value;
-        else if (key == "cpp_version") cppVersion = std::stoi(value);
+        else if (key == "cpp_version") integer(key, value, 1, 99, cppVersion);
         else if (key == "runtime_bin") runtimeBin = value;
         else if (key == "runtime_lib") runtimeLib = value;
         else if (key == "enable_debug") enableDebug = (value == "true");
         else if (key == "enable_graphics") enableGraphics = (value == "true");
         else if (key == "dependencies") dependencies = value;
+        else if (key == "build_jobs") integer(key, value, 0, INT_MAX, buildJobs);
+        else if (key == "build_generator") buildGenerator = value;
+        else if (key == "compile_cache") compileCache = (value == "true");
+        else if (key == "build_engine") buildEngine = value;
+        else if (key == "precompiled_headers") precompiledHeaders = value;
+        else if (key == "unity_build") unityBuild = (value == "true");
+        else if (key == "unity_batch_size") integer(key, value, 0, INT_MAX, unityBatchSize);
+        else if (key == "unity_batch_bytes") integer(key, value, 0, LLONG_MAX, unityBatchBytes);
+        else if (key == "unity_exclude") unityExclude = value;
+        else if (key == "compile_budget_ms") integer(key, value, 0, LLONG_MAX, compileBudgetMs);
+        else if (key == "dependency_store") dependencyStore = value;
+        else if (key == "fetch_timeout_ms") integer(key, value, 0, UINT_MAX, fetchTimeoutMs);
+        else if (key == "glad_api") gladApi = value;
+        else if (key == "package_index") packageIndex = value;
+        else if (key == "prebuilt_dependencies") prebuiltDependencies = (value == "true");
+        else if (key == "artifact_cache") artifactCache = value;
+        else if (key.rfind("mirror_", 0) == 0) mirrors[key.substr(7)] = value;
+        else if (key.rfind("rev_", 0) == 0) revisions[key.substr(4)] = value;
     }
     infile.close();
+    if (!valid) return false;
+
+    hasManifest = false;
+    std::string manifestPath = path + "/" + Manifest::FILE_NAME;
+    if (std::filesystem::exists(manifestPath)) {
+        std::string error;
+        if (!manifest.load(manifestPath, error)) {
+            std::cerr << COLOR_RED << "Invalid manifest: " << error << COLOR_RESET << std::endl;
+            return false;
+        }
+        hasManifest = true;
+    }
     return true;
 }
 
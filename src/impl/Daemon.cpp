@@ -0,0 +1,403 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include "harbour.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t MAX_REQUEST_BYTES = 256 * 1024;
+// Sent instead of an exit code when a build is already running; the client
+// then builds in-process rather than waiting behind it
+const int BUSY = -1;
+
+// Environment that can change what a build does; part of the no-op key
+const char* KEY_ENV[] = {"PATH", "CXX", "CC", "CXXFLAGS", "CFLAGS", "CPPFLAGS", "LDFLAGS",
+                         "CMAKE_PREFIX_PATH", "CMAKE_GENERATOR", "CMAKE_TOOLCHAIN_FILE", "PKG_CONFIG_PATH",
+                         "HARBOUR_CACHE_DIR"};
+
+bool fillAddress(sockaddr_un& addr, const std::string& path) {
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    return true;
+}
+
+int connectTo(const std::string& path) {
+    sockaddr_un addr;
+    if (!fillAddress(addr, path)) return -1;
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void say(int fd, const std::string& text) {
+    size_t done = 0;
+    while (done < text.size()) {
+        ssize_t n = write(fd, text.data() + done, text.size() - done);
+        if (n <= 0) return;
+        done += static_cast<size_t>(n);
+    }
+}
+
+std::string getEnv(const std::vector<std::string>& env, const std::string& name) {
+    for (const auto& entry : env)
+        if (entry.size() > name.size() && entry.compare(0, name.size(), name) == 0 && entry[name.size()] == '=')
+            return entry.substr(name.size() + 1);
+    return "";
+}
+
+// One forward(): the command, where and with what environment it ran, and
+// the client's stdout/stderr
+struct Request {
+    std::vector<std::string> args;
+    std::string cwd;
+    std::vector<std::string> env;
+    int fds[2] = {-1, -1};
+};
+
+bool receive(int client, std::vector<char>& buf, Request& request) {
+    iovec iov{buf.data(), buf.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n = recvmsg(client, &msg, MSG_CMSG_CLOEXEC);
+    cmsghdr* cmsg = n > 0 ? CMSG_FIRSTHDR(&msg) : nullptr;
+    if (cmsg && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(request.fds)))
+        std::memcpy(request.fds, CMSG_DATA(cmsg), sizeof(request.fds));
+
+    std::vector<std::string> fields;
+    for (ssize_t start = 0, i = 0; i < n; ++i) {
+        if (buf[i] != '\0') continue;
+        fields.emplace_back(buf.data() + start, i - start);
+        start = i + 1;
+    }
+    size_t argc = fields.empty() ? 0 : std::strtoul(fields[0].c_str(), nullptr, 10);
+    if (request.fds[0] < 0 || request.fds[1] < 0 || argc == 0 || fields.size() < argc + 2) return false;
+    request.args.assign(fields.begin() + 1, fields.begin() + 1 + argc);
+    request.cwd = fields[1 + argc];
+    request.env.assign(fields.begin() + 2 + argc, fields.end());
+    return true;
+}
+
+// Sends the exit code and lets go of the client
+void reply(int client, const Request& request, int code) {
+    send(client, &code, sizeof(code), MSG_NOSIGNAL);
+    for (int fd : request.fds)
+        if (fd >= 0) close(fd);
+    close(client);
+}
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+} // namespace
+
+std::string Daemon::socketPath() {
+    if (const char* path = std::getenv("HARBOUR_DAEMON_SOCKET")) return path;
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR")) return std::string(runtime) + "/harbour/harbourd.sock";
+    return "/tmp/harbour-" + std::to_string(getuid()) + "/harbourd.sock";
+}
+
+bool Daemon::forward(const std::vector<std::string>& args, int& exitCode) {
+    const char* off = std::getenv("HARBOUR_NO_DAEMON");
+    if (off && *off && std::string(off) != "0") return false;
+    int fd = connectTo(socketPath());
+    if (fd < 0) return false;
+
+    // One packet: argc, argv..., cwd, environment, with stdout/stderr attached
+    std::string payload = std::to_string(args.size()) + '\0';
+    for (const auto& arg : args) payload += arg + '\0';
+    std::error_code ec;
+    payload += fs::current_path(ec).string() + '\0';
+    for (char** env = environ; *env; ++env) payload += std::string(*env) + '\0';
+
+    iovec iov{payload.data(), payload.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(2 * sizeof(int));
+    int fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+    std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+    std::cout.flush();
+    if (payload.size() > MAX_REQUEST_BYTES || sendmsg(fd, &msg, MSG_NOSIGNAL) < 0) {
+        close(fd);
+        return false;
+    }
+
+    int code = 1;
+    ssize_t n;
+    while ((n = recv(fd, &code, sizeof(code), 0)) < 0 && errno == EINTR) {}
+    close(fd);
+    if (n != sizeof(code)) {
+        std::cerr << COLOR_RED << "Lost connection to harbourd" << COLOR_RESET << std::endl;
+        code = 1;
+    }
+    if (code == BUSY) return false;
+    exitCode = code;
+    return true;
+}
+
+bool Daemon::start() {
+    std::string path = socketPath();
+    int probe = connectTo(path);
+    if (probe >= 0) {
+        close(probe);
+        return false;
+    }
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        setsid();
+        int null = open("/dev/null", O_RDWR);
+        std::string logPath = fs::path(path).parent_path() / "harbourd.log";
+        int log = open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0600);
+        dup2(null, STDIN_FILENO);
+        dup2(log >= 0 ? log : null, STDOUT_FILENO);
+        dup2(log >= 0 ? log : null, STDERR_FILENO);
+        Daemon daemon;
+        _exit(daemon.serve());
+    }
+    for (int i = 0; i < 100; ++i) {
+        int fd = connectTo(path);
+        if (fd >= 0) {
+            close(fd);
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+int Daemon::serve() {
+    std::string path = socketPath();
+    sockaddr_un addr;
+    if (!fillAddress(addr, path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return 1;
+    }
+    std::error_code ec;
+    std::string dir = fs::path(path).parent_path().string();
+    fs::create_directories(dir, ec);
+    // Close our own directory to other users before the socket appears in
+    // it. A directory named by HARBOUR_DAEMON_SOCKET is left alone, and the
+    // umask keeps the socket itself private from the moment it exists.
+    if (!std::getenv("HARBOUR_DAEMON_SOCKET") && chmod(dir.c_str(), 0700) != 0) {
+        std::cerr << "Cannot make " << dir << " private: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    int probe = connectTo(path);
+    if (probe >= 0) {
+        close(probe);
+        std::cerr << "harbourd is already running on " << path << std::endl;
+        return 1;
+    }
+    unlink(path.c_str());  // stale socket from a daemon that died
+    listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    mode_t mask = umask(077);
+    bool listening = listenFd >= 0 && bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                     listen(listenFd, 16) == 0;
+    int bindError = errno;
+    umask(mask);
+    if (!listening) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(bindError) << std::endl;
+        return 1;
+    }
+    chmod(path.c_str(), 0600);
+
+    struct sigaction action {};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+    std::cout << "harbourd listening on " << path << " (pid " << getpid() << ")" << std::endl;
+
+    std::vector<char> buf(MAX_REQUEST_BYTES);
+    while (!stopRequested) {
+        int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;  // EINTR on stop, or a client that gave up
+
+        Request request;
+        int code = 1;
+        if (receive(client, buf, request))
+            code = handle(client, request.args, request.cwd, request.env, request.fds[0], request.fds[1]);
+        reply(client, request, code);
+    }
+    close(listenFd);
+    unlink(path.c_str());
+    std::cout << "harbourd stopped" << std::endl;
+    return 0;
+}
+
+Daemon::ProjectState* Daemon::track(const std::string& path) {
+    auto it = projects.find(path);
+    if (it != projects.end()) return &it->second;
+    ProjectState state;
+    if (!state.cfg.readConfig(path)) return nullptr;
+    state.watcher = std::make_unique<Watcher>(path, false, BuildOptions{}, false, 0);
+    if (!state.watcher->start()) return nullptr;
+    return &projects.emplace(path, std::move(state)).first->second;
+}
+
+int Daemon::handle(int client, const std::vector<std::string>& args, const std::string& cwd,
+                   const std::vector<std::string>& env, int outFd, int errFd) {
+    if (args[0] == "daemon") return control(args, outFd);
+    if (args[0] != "build") return runWorker(client, args, cwd, env, outFd, errFd);
+
+    std::vector<std::string> argvStore = {"harbour"};
+    argvStore.insert(argvStore.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (auto& arg : argvStore) argv.push_back(arg.data());
+    bool debugMode = false, cleanBuild = false;
+    BuildOptions options;
+    int i = 2;
+    // Let the worker report bad flags; it owns the client's terminal
+    if (!CLI::parseBuildFlags(argv.size(), argv.data(), i, debugMode, cleanBuild, options))
+        return runWorker(client, args, cwd, env, outFd, errFd);
+    std::error_code ec;
+    std::string path = fs::weakly_canonical(fs::path(cwd) / (i < static_cast<int>(argv.size()) ? argv[i] : "."), ec);
+    ProjectState* state = track(path);
+    if (!state) return runWorker(client, args, cwd, env, outFd, errFd);
+
+    auto refresh = [&] {
+        auto change = state->watcher->waitForChanges(0);
+        if (change == Watcher::Change::Config) state->cfg.readConfig(path);
+        if (change != Watcher::Change::None) state->upToDateKey.clear();
+        return change;
+    };
+    refresh();
+
+    // Same arguments and environment as the last clean build, and nothing
+    // on disk has changed since: there is nothing for cmake to do.
+    bool cacheable = !cleanBuild && options.traceFile.empty() && !options.profileCompile;
+    std::string key = cwd;
+    for (const auto& arg : args) key += '\0' + arg;
+    for (const char* var : KEY_ENV) key += '\0' + getEnv(env, var);
+    std::string binary = path + "/build/" + (debugMode ? "debug" : "release") + "/" + state->cfg.runtimeBin + "/" +
+                         state->cfg.projectName;
+    if (cacheable && state->upToDateKey == key && fs::exists(binary, ec)) {
+        say(outFd, std::string(COLOR_GREEN) + "Up to date (harbourd), nothing to build." + COLOR_RESET + "\n");
+        return 0;
+    }
+
+    state->upToDateKey.clear();
+    int code = runWorker(client, args, cwd, env, outFd, errFd);
+    // Edits made while the build ran may not be in its output
+    if (refresh() == Watcher::Change::None && code == 0 && cacheable) state->upToDateKey = key;
+    return code;
+}
+
+int Daemon::control(const std::vector<std::string>& args, int outFd) {
+    std::string sub = args.size() > 1 ? args[1] : "status";
+    if (sub == "stop") {
+        stopRequested = 1;
+        say(outFd, running.empty() ? "harbourd stopping\n" : "harbourd stopping after the current command\n");
+        return 0;
+    }
+    std::string status = "harbourd running (pid " + std::to_string(getpid()) + "), tracking " +
+                         std::to_string(projects.size()) + " project(s)\n";
+    for (const auto& [path, state] : projects)
+        status += "  " + path + (state.upToDateKey.empty() ? "" : " (up to date)") + "\n";
+    if (!running.empty()) status += "  running: harbour " + running + "\n";
+    say(outFd, status);
+    return 0;
+}
+
+void Daemon::answerWhileBusy() {
+    int client = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) return;
+    std::vector<char> buf(MAX_REQUEST_BYTES);
+    Request request;
+    int code = 1;
+    if (receive(client, buf, request))
+        code = request.args[0] == "daemon" ? control(request.args, request.fds[0]) : BUSY;
+    reply(client, request, code);
+}
+
+int Daemon::runWorker(int client, const std::vector<std::string>& args, const std::string& cwd,
+                      const std::vector<std::string>& env, int outFd, int errFd) {
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        say(errFd, "harbourd: fork() failed\n");
+        return 1;
+    }
+    if (pid == 0) {
+        setpgid(0, 0);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGPIPE, SIG_DFL);
+        dup2(outFd, STDOUT_FILENO);
+        dup2(errFd, STDERR_FILENO);
+        if (chdir(cwd.c_str()) != 0) _exit(1);
+        clearenv();
+        for (const auto& entry : env) putenv(strdup(entry.c_str()));
+        setenv("HARBOUR_NO_DAEMON", "1", 1);  // the worker must not forward back to us
+        std::vector<std::string> argvStore = {"harbour"};
+        argvStore.insert(argvStore.end(), args.begin(), args.end());
+        std::vector<char*> argv;
+        for (auto& arg : argvStore) argv.push_back(arg.data());
+        argv.push_back(nullptr);
+        CLI cli;
+        int code = cli.run(static_cast<int>(argvStore.size()), argv.data());
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(code);
+    }
+    setpgid(pid, pid);
+    running.clear();
+    for (const auto& arg : args) running += (running.empty() ? "" : " ") + arg;
+
+    // A client that goes away (Ctrl+C) takes its build with it. Meanwhile
+    // status and stop are still answered; anything else is told we are busy.
+    int status = 0;
+    pollfd pfds[2] = {{client, POLLIN, 0}, {listenFd, POLLIN, 0}};
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (poll(pfds, 2, 50) <= 0) continue;
+        if (pfds[0].revents) {
+            kill(-pid, SIGTERM);
+            waitpid(pid, &status, 0);
+            kill(-pid, SIGKILL);
+            break;
+        }
+        if (pfds[1].revents & POLLIN) answerWhileBusy();
+    }
+    running.clear();
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+} // namespace Project
+} // namespace Harbour
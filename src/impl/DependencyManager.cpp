@@ -1,66 +1,276 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "harbour.hpp"
+#include "trace.hpp"
 
 namespace Harbour {
 namespace Project {
 
-bool DependencyManager::checkDependencies(bool enableGraphics) {
+namespace {
+
+struct Dependency {
+    const char* name;
+    const char* key;    // mirror_<key> / rev_<key> in .harbourConfig
+    const char* url;
+    const char* rev;    // pinned revision
+    const char* dir;
+    bool generateGlad;  // run the glad generator right after the checkout
+};
+
+const Dependency GRAPHICS_DEPENDENCIES[] = {
+    {"GLFW", "glfw", "https://github.com/glfw/glfw.git", "3.4", "external/glfw", false},
+    {"GLM", "glm", "https://github.com/g-truc/glm.git", "1.0.1", "external/glm", false},
+    {"GLAD", "glad", "https://github.com/Dav1dde/glad.git", "v2.0.8", "external/glad", true},
+};
+
+// Where a dependency comes from: .harbourConfig, then $HARBOUR_MIRROR_<DEP>
+// / $HARBOUR_REV_<DEP>, then the upstream default
+std::string sourceSetting(const std::map<std::string, std::string>& config, const Dependency& dep,
+                          const char* envPrefix, const char* fallback) {
+    auto it = config.find(dep.key);
+    if (it != config.end() && !it->second.empty()) return it->second;
+    if (const char* env = std::getenv((std::string(envPrefix) + dep.name).c_str())) return env;
+    return fallback;
+}
+
+// Serializes progress lines from the fetch workers
+class Progress {
+    std::mutex mtx;
+
+public:
+    void line(const char* color, const std::string& name, const std::string& text) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::cout << color << "[" << name << "] " << text << COLOR_RESET << std::endl;
+    }
+};
+
+std::string lastLine(const std::string& text) {
+    auto end = text.find_last_not_of("\n ");
+    if (end == std::string::npos) return "";
+    auto start = text.rfind('\n', end);
+    return text.substr(start == std::string::npos ? 0 : start + 1, end - (start == std::string::npos ? 0 : start + 1) + 1);
+}
+
+std::string seconds(std::chrono::steady_clock::time_point since) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count() << "s";
+    return out.str();
+}
+
+// Reports a failed step and raises `cancel` so the other workers stop too
+void reportFailure(const Dependency& dep, const std::string& what, const std::string& error,
+                   std::atomic<bool>& cancel, Progress& progress) {
+    if (error == "cancelled" || (cancel && error.empty())) {
+        progress.line(COLOR_YELLOW, dep.name, "cancelled");
+        return;
+    }
+    progress.line(COLOR_RED, dep.name, what + " failed: " + lastLine(error));
+    cancel = true;
+}
+
+// Written next to the generated loader so a changed glad_api is noticed
+const char* GLAD_API_STAMP = "GL/.harbour-glad-api";
+
+std::string gladApiOf(const std::string& dir) {
+    std::ifstream stamp(std::filesystem::path(dir) / GLAD_API_STAMP);
+    std::string api;
+    std::getline(stamp, api);
+    return api.empty() ? DependencyManager::DEFAULT_GLAD_API : api;
+}
+
+// Fills <dir>/GL with the GLAD loader for `api`. The output depends only on
+// the glad commit and the spec, so it is generated once into the store and
+// copied from there for every later project.
+bool generateLoader(const Dependency& dep, const std::string& commit, const std::string& api, DependencyStore& store,
+                    std::atomic<bool>& cancel, Progress& progress) {
+    std::string out = std::string(dep.dir) + "/GL";
+    std::string inputs = commit + "\n" + api + "\nc";
+    std::string error;
+    std::string cached = store.generated(dep.key, inputs);
+    if (!cached.empty()) {
+        progress.line(COLOR_YELLOW, dep.name, "using cached loader (" + api + ")");
+        if (DependencyStore::materialize(cached, out, error)) return true;
+        reportFailure(dep, "loader checkout", error, cancel, progress);
+        return false;
+    }
+
+    progress.line(COLOR_YELLOW, dep.name, "running glad generator (" + api + ")...");
+    Trace::Scope scope(std::string("Generate loader for ") + dep.name, "dependency");
+    std::error_code ec;
+    std::filesystem::create_directories(out, ec);
+    CommandExecutor::Options options;
+    options.cancel = &cancel;
+    options.cwd = dep.dir;
+    CommandExecutor exec;
+    auto result = exec.run({"python3", "-m", "glad", "--out-path", "./GL", "--api", api, "c"}, options);
+    if (result.exitCode != 0) {
+        reportFailure(dep, "glad generation", result.cancelled ? "cancelled" : result.error + result.output, cancel,
+                      progress);
+        return false;
+    }
+    // A loader that cannot be cached is still usable for this project
+    if (store.storeGenerated(dep.key, inputs, out, error).empty())
+        debug::print("Could not cache the ", dep.name, " loader: ", error);
+    return true;
+}
+
+// Checks one dependency out of the shared store (and generates the GLAD
+// loader). A failed or cancelled fetch leaves nothing behind, so the next
+// build retries it instead of mistaking a partial checkout for an
+// installed one.
+bool fetch(const Dependency& dep, const std::string& url, const std::string& rev, const std::string& gladApi,
+           DependencyStore& store, std::atomic<bool>& cancel, Progress& progress, Lockfile::Entry& locked) {
+    auto start = std::chrono::steady_clock::now();
+    progress.line(COLOR_YELLOW, dep.name, "resolving " + rev + " from " + url + "...");
+    std::string error, commit;
+    bool ok = false;
+    {
+        Trace::Scope scope(std::string("Fetch ") + dep.name, "dependency");
+        std::string tree = store.resolve(dep.key, url, rev, &cancel, error);
+        if (tree.empty()) reportFailure(dep, "fetch", error, cancel, progress);
+        else if (!DependencyStore::materialize(tree, dep.dir, error)) reportFailure(dep, "checkout", error, cancel, progress);
+        else ok = true;
+        commit = std::filesystem::path(tree).filename().string();
+        // Lets the artifact cache key prebuilt libraries on the commit
+        if (ok) std::ofstream(std::filesystem::path(dep.dir) / ArtifactCache::REVISION_FILE) << commit << "\n";
+    }
+    if (ok && dep.generateGlad) {
+        ok = generateLoader(dep, commit, gladApi, store, cancel, progress);
+        if (ok) std::ofstream(std::filesystem::path(dep.dir) / GLAD_API_STAMP) << gladApi << "\n";
+    }
+    if (!ok) {
+        std::error_code ec;
+        std::filesystem::remove_all(dep.dir, ec);
+        return false;
+    }
+    locked = {url, rev, commit, Lockfile::treeHash(dep.dir), Lockfile::statSnapshot(dep.dir)};
+    progress.line(COLOR_GREEN, dep.name, "ready in " + seconds(start));
+    return true;
+}
+
+// Why an existing checkout cannot be used, or "" when it is intact. The
+// common case costs one lstat() per entry in the tree; contents are only
+// re-hashed when the stat snapshot moved or `verify` is set, and a tree
+// that still hashes the same just gets its snapshot refreshed.
+std::string checkInstalled(const Dependency& dep, const std::string& url, const std::string& rev,
+                           const std::string& gladApi, bool verify, Lockfile& lock, bool& lockChanged) {
+    namespace fs = std::filesystem;
+    if (dep.generateGlad && gladApiOf(dep.dir) != gladApi) return "was generated for " + gladApiOf(dep.dir);
+    const Lockfile::Entry* locked = lock.find(dep.key);
+    if (!locked) {
+        // Checkouts from before harbour.lock: adopt the ones that completed
+        bool complete = fs::exists(fs::path(dep.dir) / ".git") ||
+                        (fs::exists(fs::path(dep.dir) / ArtifactCache::REVISION_FILE) &&
+                         (!dep.generateGlad || fs::exists(fs::path(dep.dir) / GLAD_API_STAMP)));
+        if (!complete) return "is incomplete";
+        std::ifstream stamp(fs::path(dep.dir) / ArtifactCache::REVISION_FILE);
+        std::string commit;
+        std::getline(stamp, commit);
+        lock.set(dep.key, {url, rev, commit, Lockfile::treeHash(dep.dir), Lockfile::statSnapshot(dep.dir)});
+        lockChanged = true;
+        return "";
+    }
+    if (locked->rev != rev) return "is locked to " + locked->rev;
+    std::string snapshot = Lockfile::statSnapshot(dep.dir);
+    if (snapshot == locked->snapshot && !verify) return "";
+    debug::print("Hashing ", dep.dir, verify ? " (--verify)" : " (stat snapshot changed)");
+    if (Lockfile::treeHash(dep.dir) != locked->hash) return "does not match " + std::string(Lockfile::FILE_NAME);
+    if (snapshot != locked->snapshot) {
+        Lockfile::Entry refreshed = *locked;
+        refreshed.snapshot = snapshot;
+        lock.set(dep.key, refreshed);
+        lockChanged = true;
+    }
+    return "";
+}
+
+} // namespace
+
+DependencyManager::DependencyManager(unsigned jobs) : jobs(jobs) {}
+
+DependencyManager::DependencyManager(const ConfigManager& cfg, unsigned jobs)
+    : jobs(jobs), mirrors(cfg.mirrors), revisions(cfg.revisions), storeDir(cfg.dependencyStore),
+      fetchTimeoutMs(cfg.fetchTimeoutMs),
+      gladApi(cfg.gladApi.empty() ? DEFAULT_GLAD_API : cfg.gladApi) {}
+
+bool DependencyManager::checkDependencies(bool enableGraphics, bool verify) {
     if (!enableGraphics) return true;
     namespace fs = std::filesystem;
     fs::create_directories("external");
-    if (!fs::exists("external/glfw")) {
-        std::string cmd = "git clone https://github.com/glfw/glfw.git external/glfw";
-        debug::print(cmd);
-        std::cout << COLOR_YELLOW << "Cloning GLFW..." << COLOR_RESET << std::endl;
-        Harbour::CommandExecutor exec;
-        auto args = std::vector<std::string>{"/bin/sh", "-c", cmd};
-        auto result = exec.run(args, true);
-        if (result.exitCode != 0) {
-            debug::print("GLFW clone failed: ", result.error, result.output);
-            return false;
-        }
-    } else {
-        std::cout << COLOR_GREEN << "GLFW found" << COLOR_RESET << std::endl;
-    }
-    if (!fs::exists("external/glm")) {
-        std::string cmd = "git clone https://github.com/g-truc/glm.git external/glm";
-        debug::print(cmd);
-        std::cout << COLOR_YELLOW << "Cloning GLM..." << COLOR_RESET << std::endl;
-        Harbour::CommandExecutor exec;
-        auto args = std::vector<std::string>{"/bin/sh", "-c", cmd};
-        auto result = exec.run(args, true);
-        if (result.exitCode != 0) {
-            debug::print("GLM clone failed: ", result.error, result.output);
-            return false;
-        }
-    } else {
-        std::cout << COLOR_GREEN << "GLM found" << COLOR_RESET << std::endl;
+
+    Lockfile lock;
+    if (!lock.read(Lockfile::FILE_NAME)) {
+        std::cerr << COLOR_RED << "Cannot read " << Lockfile::FILE_NAME << COLOR_RESET << std::endl;
+        return false;
     }
-    if (!fs::exists("external/glad")) {
-        std::string cmd = "git clone https://github.com/Dav1dde/glad.git external/glad";
-        debug::print(cmd);
-        std::cout << COLOR_YELLOW << "Cloning GLAD..." << COLOR_RESET << std::endl;
-        Harbour::CommandExecutor exec;
-        auto args = std::vector<std::string>{"/bin/sh", "-c", cmd};
-        auto result = exec.run(args, true);
-        if (result.exitCode != 0) {
-            debug::print("GLAD clone failed: ", result.error, result.output);
-            return false;
+    bool lockChanged = false;
+    std::vector<const Dependency*> missing;
+    for (const auto& dep : GRAPHICS_DEPENDENCIES) {
+        std::string url = sourceSetting(mirrors, dep, "HARBOUR_MIRROR_", dep.url);
+        std::string rev = sourceSetting(revisions, dep, "HARBOUR_REV_", dep.rev);
+        if (!fs::exists(dep.dir)) {
+            missing.push_back(&dep);
+            continue;
         }
-        std::string gladCmd = "cd external/glad && mkdir -p GL && python3 -m glad --out-path ./GL --api gl:compatibility=3.3 c";
-        debug::print(gladCmd);
-        std::cout << COLOR_YELLOW << "Running glad generator (OpenGL C 3.3 compatibility)..." << COLOR_RESET << std::endl;
-        auto gladArgs = std::vector<std::string>{"/bin/sh", "-c", gladCmd};
-        auto gladResult = exec.run(gladArgs, true);
-        if (gladResult.exitCode != 0) {
-            debug::print("GLAD generation failed: ", gladResult.error, gladResult.output);
-            return false;
+        std::string problem = checkInstalled(dep, url, rev, gladApi, verify, lock, lockChanged);
+        if (problem.empty()) {
+            std::cout << COLOR_GREEN << dep.name << " found" << COLOR_RESET << std::endl;
+        } else {
+            // The checkout comes back from the store, so this is cheap
+            std::cout << COLOR_YELLOW << dep.name << " " << problem << ", refetching" << COLOR_RESET << std::endl;
+            fs::remove_all(dep.dir);
+            missing.push_back(&dep);
         }
-    } else {
-        std::cout << COLOR_GREEN << "GLAD found" << COLOR_RESET << std::endl;
     }
-    return true;
+    if (missing.empty()) {
+        if (lockChanged && !lock.write(Lockfile::FILE_NAME))
+            std::cerr << COLOR_RED << "Cannot write " << Lockfile::FILE_NAME << COLOR_RESET << std::endl;
+        return true;
+    }
+
+    // Clones are network bound, so run them side by side; each worker takes
+    // the next missing dependency until the list is done or one fails.
+    unsigned workers = std::min<unsigned>(jobs ? jobs : MAX_FETCH_JOBS, missing.size());
+    std::cout << COLOR_YELLOW << "Fetching " << missing.size() << " dependencies with " << workers << " worker(s)..."
+              << COLOR_RESET << std::endl;
+    std::atomic<bool> cancel{false};
+    std::atomic<size_t> next{0};
+    Progress progress;
+    DependencyStore store(storeDir, fetchTimeoutMs);
+    std::vector<Lockfile::Entry> fetched(missing.size());
+    std::vector<char> succeeded(missing.size(), 0);
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < workers; ++i) {
+        pool.emplace_back([&] {
+            size_t index;
+            while (!cancel && (index = next++) < missing.size()) {
+                const Dependency& dep = *missing[index];
+                succeeded[index] = fetch(dep, sourceSetting(mirrors, dep, "HARBOUR_MIRROR_", dep.url),
+                                         sourceSetting(revisions, dep, "HARBOUR_REV_", dep.rev), gladApi, store,
+                                         cancel, progress, fetched[index]);
+            }
+        });
+    }
+    for (auto& worker : pool) worker.join();
+
+    // Record whatever did land, even when another fetch failed
+    for (size_t i = 0; i < missing.size(); ++i)
+        if (succeeded[i]) lock.set(missing[i]->key, fetched[i]);
+    if (!lock.write(Lockfile::FILE_NAME))
+        std::cerr << COLOR_RED << "Cannot write " << Lockfile::FILE_NAME << COLOR_RESET << std::endl;
+    return !cancel;
 }
 
 } // namespace Project
@@ -0,0 +1,156 @@
+#include <cstdlib>
+#include <filesystem>
+#include "harbour.hpp"
+#include "hash.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string trimmed(std::string s) {
+    while (!s.empty() && (s.back() == '\n' || s.back() == ' ')) s.pop_back();
+    return s;
+}
+
+CommandExecutor::Result run(const std::vector<std::string>& args, const std::atomic<bool>* cancel,
+                            unsigned timeoutMs = 0) {
+    CommandExecutor::Options options;
+    options.cancel = cancel;
+    options.timeoutMs = timeoutMs;
+    CommandExecutor exec;
+    return exec.run(args, options);
+}
+
+// git against a bare mirror
+CommandExecutor::Result git(const std::string& mirror, std::vector<std::string> args,
+                            const std::atomic<bool>* cancel, unsigned timeoutMs = 0) {
+    args.insert(args.begin(), {"git", "--git-dir=" + mirror});
+    return run(args, cancel, timeoutMs);
+}
+
+void makeReadOnly(const fs::path& tree) {
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(tree, ec))
+        if (entry.is_regular_file(ec))
+            fs::permissions(entry.path(), fs::perms::owner_write | fs::perms::group_write | fs::perms::others_write,
+                            fs::perm_options::remove, ec);
+}
+
+fs::path generatedPath(const std::string& dir, const std::string& name, const std::string& inputs) {
+    return fs::path(dir) / "generated" / (name + "-" + Hash::ofString(inputs).substr(0, 16));
+}
+
+} // namespace
+
+DependencyStore::DependencyStore(const std::string& dir, unsigned fetchTimeoutMs)
+    : dir(dir.empty() ? defaultDir() : dir), fetchTimeoutMs(fetchTimeoutMs) {}
+
+std::string DependencyStore::defaultDir() {
+    if (const char* store = std::getenv("HARBOUR_STORE")) return store;
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.harbour/store";
+    return "/tmp/harbour-store";
+}
+
+std::string DependencyStore::resolve(const std::string& name, const std::string& url, const std::string& rev,
+                                     const std::atomic<bool>* cancel, std::string& error) {
+    std::error_code ec;
+    fs::create_directories(fs::path(dir) / "mirrors", ec);
+    fs::create_directories(fs::path(dir) / "trees", ec);
+    std::string mirror = (fs::path(dir) / "mirrors" / (name + "-" + Hash::ofString(url).substr(0, 12) + ".git")).string();
+    std::string ref = "refs/harbour/" + rev;
+
+    std::string commit;
+    {
+        // Serializes fetches into one mirror across harbour processes
+        FH::FileLock lock(mirror + ".lock");
+        std::vector<std::string> verify = {"rev-parse", "--verify", "-q", ref + "^{commit}"};
+        auto found = fs::exists(mirror) ? git(mirror, verify, cancel) : CommandExecutor::Result::failed(1, "");
+        if (found.exitCode != 0) {
+            // Only the pinned revision, without history
+            auto fetched = run({"git", "init", "-q", "--bare", mirror}, cancel);
+            if (fetched.exitCode == 0)
+                fetched = git(mirror, {"fetch", "-q", "--depth", "1", url, "+" + rev + ":" + ref}, cancel,
+                              fetchTimeoutMs);
+            if (fetched.exitCode != 0) {
+                if (fetched.timedOut) error = "fetch timed out after " + std::to_string(fetchTimeoutMs) + " ms";
+                else error = fetched.cancelled ? "cancelled" : trimmed(fetched.error + fetched.output);
+                return "";
+            }
+            found = git(mirror, verify, cancel);
+        }
+        commit = trimmed(found.output);
+        if (found.exitCode != 0 || commit.empty()) {
+            error = "revision " + rev + " is not a commit";
+            return "";
+        }
+    }
+
+    fs::path tree = fs::path(dir) / "trees" / commit;
+    if (fs::exists(tree)) return tree.string();
+    fs::path tmp = FH::tempSibling(tree);
+    fs::create_directories(tmp, ec);
+    // Through a file rather than a `git archive | tar` shell pipeline
+    std::string archive = tmp.string() + ".tar";
+    auto extracted = git(mirror, {"archive", "--output=" + archive, commit}, cancel);
+    if (extracted.exitCode == 0) extracted = run({"tar", "-x", "-f", archive, "-C", tmp.string()}, cancel);
+    fs::remove(archive, ec);
+    if (extracted.exitCode != 0) {
+        error = extracted.cancelled ? "cancelled" : trimmed(extracted.error + extracted.output);
+        fs::remove_all(tmp, ec);
+        return "";
+    }
+    makeReadOnly(tmp);
+    if (!FH::publish(tmp, tree, ec)) {
+        error = ec.message();
+        return "";
+    }
+    return tree.string();
+}
+
+std::string DependencyStore::generated(const std::string& name, const std::string& inputs) const {
+    fs::path entry = generatedPath(dir, name, inputs);
+    return fs::exists(entry) ? entry.string() : "";
+}
+
+std::string DependencyStore::storeGenerated(const std::string& name, const std::string& inputs,
+                                            const std::string& output, std::string& error) {
+    std::error_code ec;
+    fs::path entry = generatedPath(dir, name, inputs);
+    if (fs::exists(entry)) return entry.string();
+    fs::create_directories(entry.parent_path(), ec);
+    fs::path tmp = FH::tempSibling(entry);
+    fs::copy(output, tmp, fs::copy_options::recursive, ec);
+    if (ec) {
+        error = ec.message();
+        fs::remove_all(tmp, ec);
+        return "";
+    }
+    makeReadOnly(tmp);
+    if (!FH::publish(tmp, entry, ec)) {
+        error = ec.message();
+        return "";
+    }
+    return entry.string();
+}
+
+bool DependencyStore::materialize(const std::string& tree, const std::string& dest, std::string& error) {
+    std::error_code ec;
+    fs::create_directories(fs::path(dest).parent_path(), ec);
+    CommandExecutor exec;
+    if (exec.run({"cp", "-R", "--reflink=always", tree, dest}, true).exitCode == 0) return true;
+    fs::remove_all(dest, ec);
+    fs::copy(tree, dest, fs::copy_options::recursive | fs::copy_options::create_hard_links, ec);
+    if (!ec) return true;
+    fs::remove_all(dest, ec);
+    fs::copy(tree, dest, fs::copy_options::recursive, ec);
+    if (!ec) return true;
+    error = ec.message();
+    fs::remove_all(dest, ec);
+    return false;
+}
+
+} // namespace Project
+} // namespace Harbour
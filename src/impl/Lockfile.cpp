@@ -0,0 +1,110 @@
+#include <sys/stat.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "harbour.hpp"
+#include "hash.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Every path under dir, sorted so the digests do not depend on readdir order
+std::vector<fs::path> sortedTree(const std::string& dir) {
+    std::vector<fs::path> paths;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(dir, ec)) paths.push_back(entry.path());
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace
+
+bool Lockfile::read(const std::string& path) {
+    entries.clear();
+    std::ifstream in(path);
+    if (!in) return !fs::exists(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        // <dependency>.<field>=<value>
+        auto eq = line.find('=');
+        auto dot = line.find('.');
+        if (eq == std::string::npos || dot == std::string::npos || dot > eq) continue;
+        Entry& entry = entries[line.substr(0, dot)];
+        std::string field = line.substr(dot + 1, eq - dot - 1);
+        std::string value = line.substr(eq + 1);
+        if (field == "url") entry.url = value;
+        else if (field == "rev") entry.rev = value;
+        else if (field == "commit") entry.commit = value;
+        else if (field == "hash") entry.hash = value;
+        else if (field == "snapshot") entry.snapshot = value;
+    }
+    return true;
+}
+
+bool Lockfile::write(const std::string& path) const {
+    // Written aside and renamed so a crash never leaves half a lockfile
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return false;
+        out << "# Generated by harbour; records the dependencies under external/\n";
+        for (const auto& [name, entry] : entries) {
+            out << name << ".url=" << entry.url << "\n";
+            out << name << ".rev=" << entry.rev << "\n";
+            out << name << ".commit=" << entry.commit << "\n";
+            out << name << ".hash=" << entry.hash << "\n";
+            out << name << ".snapshot=" << entry.snapshot << "\n";
+        }
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+const Lockfile::Entry* Lockfile::find(const std::string& name) const {
+    auto it = entries.find(name);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+std::string Lockfile::treeHash(const std::string& dir) {
+    Hash::Hasher hasher;
+    for (const auto& path : sortedTree(dir)) {
+        std::error_code ec;
+        auto status = fs::symlink_status(path, ec);
+        if (fs::is_directory(status)) continue;
+        hasher.update(path.lexically_relative(dir).string());
+        if (fs::is_symlink(status)) {
+            hasher.update("link:" + fs::read_symlink(path, ec).string());
+            continue;
+        }
+        bool executable = (status.permissions() & fs::perms::owner_exec) != fs::perms::none;
+        hasher.update(executable ? "x" : "-");
+        if (!hasher.updateFile(path)) hasher.update("unreadable");
+    }
+    return hasher.hex();
+}
+
+std::string Lockfile::statSnapshot(const std::string& dir) {
+    Hash::Hasher hasher;
+    for (const auto& path : sortedTree(dir)) {
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0) continue;
+        hasher.update(path.lexically_relative(dir).string());
+        hasher.update(static_cast<long long>(st.st_mtim.tv_sec));
+        hasher.update(static_cast<long long>(st.st_mtim.tv_nsec));
+        hasher.update(static_cast<long long>(st.st_ino));
+        hasher.update(static_cast<long long>(st.st_size));
+        hasher.update(static_cast<long long>(st.st_mode));
+    }
+    return hasher.hex();
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,83 @@
+#include <fstream>
+#include <sstream>
+#include "harbour.hpp"
+#include "json.hpp"
+
+namespace Harbour {
+namespace Project {
+
+bool Manifest::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot read " + path;
+        return false;
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    if (parse(text.str(), error)) return true;
+    error = path + ": " + error;
+    return false;
+}
+
+bool Manifest::parse(std::string_view text, std::string& error) {
+    *this = Manifest();
+    Json::Value root;
+    if (!Json::parse(text, root, &error)) return false;
+    if (!root.isObject()) {
+        error = "expected an object";
+        return false;
+    }
+    if (const Json::Value* info = root.find("info")) {
+        name = info->get("name");
+        type = info->get("type");
+        version = info->get("version");
+    }
+    if (const Json::Value* list = root.find("scripts")) {
+        if (!list->isObject()) {
+            error = "\"scripts\" must be an object";
+            return false;
+        }
+        for (const auto& [key, value] : list->members) {
+            Script entry{Json::unescape(key), {}};
+            if (value.isString()) {
+                entry.commands.push_back(value.str());
+            } else if (value.isArray()) {
+                for (const auto& command : value.items) {
+                    if (!command.isString()) {
+                        error = "script " + entry.name + " must hold strings";
+                        return false;
+                    }
+                    entry.commands.push_back(command.str());
+                }
+            } else {
+                error = "script " + entry.name + " must be a string or an array";
+                return false;
+            }
+            scripts.push_back(std::move(entry));
+        }
+    }
+    if (const Json::Value* deps = root.find("dependencies")) {
+        if (!deps->isObject()) {
+            error = "\"dependencies\" must be an object";
+            return false;
+        }
+        dependencies.reserve(deps->members.size());
+        for (const auto& [key, range] : deps->members) {
+            if (!range.isString()) {
+                error = "the range for " + Json::unescape(key) + " must be a string";
+                return false;
+            }
+            dependencies.emplace_back(Json::unescape(key), range.str());
+        }
+    }
+    return true;
+}
+
+const Manifest::Script* Manifest::script(const std::string& scriptName) const {
+    for (const auto& entry : scripts)
+        if (entry.name == scriptName) return &entry;
+    return nullptr;
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "harbour.hpp"
+#include "hash.hpp"
+#include "NativeBuilder.hpp"
+#include "sysinfo.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* GRAPH_FILE = ".harbour-graph";
+
+// What the previous build knew about one object file
+struct GraphEntry {
+    std::string cmdHash;
+    std::vector<std::string> deps;   // every input, source included, from the depfile
+};
+
+struct Graph {
+    std::string linkHash;
+    std::map<std::string, GraphEntry> units;   // keyed by object path
+};
+
+struct Unit {
+    fs::path source;
+    fs::path object;
+    fs::path depfile;
+    std::vector<std::string> args;      // full compile command
+    std::vector<std::string> display;   // as recorded in compile_commands.json
+    std::string cmdHash;
+};
+
+// Absolute, normalized and without a trailing separator
+fs::path normalized(const std::string& p) {
+    fs::path n = fs::absolute(p).lexically_normal();
+    return n.has_filename() ? n : n.parent_path();
+}
+
+bool isCSource(const fs::path& p) { return p.extension() == ".c"; }
+
+bool isSource(const fs::path& p) {
+    auto ext = p.extension();
+    return ext == ".cpp" || ext == ".cc" || ext == ".cxx" || ext == ".c";
+}
+
+Graph loadGraph(const fs::path& file) {
+    Graph graph;
+    std::ifstream in(file);
+    std::string line;
+    GraphEntry* current = nullptr;
+    while (std::getline(in, line)) {
+        auto space = line.find(' ');
+        if (space == std::string::npos) continue;
+        std::string tag = line.substr(0, space), value = line.substr(space + 1);
+        if (tag == "link") graph.linkHash = value;
+        else if (tag == "unit") current = &graph.units[value];
+        else if (tag == "cmd" && current) current->cmdHash = value;
+        else if (tag == "dep" && current) current->deps.push_back(value);
+    }
+    return graph;
+}
+
+void saveGraph(const fs::path& file, const Graph& graph) {
+    std::ofstream out(file.string() + ".tmp");
+    out << "link " << graph.linkHash << "\n";
+    for (const auto& [object, entry] : graph.units) {
+        out << "unit " << object << "\n";
+        out << "cmd " << entry.cmdHash << "\n";
+        for (const auto& dep : entry.deps) out << "dep " << dep << "\n";
+    }
+    out.close();
+    std::error_code ec;
+    fs::rename(file.string() + ".tmp", file, ec);
+}
+
+// Parses a make-style depfile written by -MMD: "target: dep dep \\\n dep"
+std::vector<std::string> parseDepfile(const fs::path& file) {
+    std::ifstream in(file);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::string> deps;
+    auto colon = content.find(": ");
+    if (colon == std::string::npos) return deps;
+    std::string current;
+    for (size_t i = colon + 2; i < content.size(); ++i) {
+        char c = content[i];
+        if (c == '\\' && i + 1 < content.size() && content[i + 1] == ' ') {
+            current += ' ';
+            ++i;
+        } else if (c == '\\' && i + 1 < content.size() && content[i + 1] == '\n') {
+            ++i;
+        } else if (c == ' ' || c == '\n' || c == '\t') {
+            if (!current.empty()) deps.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) deps.push_back(current);
+    return deps;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string joinCommand(const std::vector<std::string>& args) {
+    std::string cmd;
+    for (const auto& arg : args) {
+        if (!cmd.empty()) cmd += ' ';
+        cmd += arg.find_first_of(" \"'") == std::string::npos ? arg : "\"" + jsonEscape(arg) + "\"";
+    }
+    return cmd;
+}
+
+} // namespace
+
+bool NativeBuilder::supports(const std::string& path, const ConfigManager& cfg) {
+    if (cfg.enableGraphics || !fs::is_directory(path + "/src")) return false;
+    std::ifstream cmake(path + "/CMakeLists.txt");
+    std::string content((std::istreambuf_iterator<char>(cmake)), std::istreambuf_iterator<char>());
+    for (const char* keyword : {"add_subdirectory", "add_library", "find_package", "target_link_libraries",
+                                "target_sources", "FetchContent", "ExternalProject"}) {
+        if (content.find(keyword) != std::string::npos) return false;
+    }
+    return true;
+}
+
+bool NativeBuilder::build(const std::string& path, const std::string& buildPath, const ConfigManager& cfg,
+                          bool debugMode, unsigned jobs, bool useCache) {
+    std::string root = normalized(path).string();
+    std::string absBuild = normalized(buildPath).string();
+    const char* cxxEnv = std::getenv("CXX");
+    const char* ccEnv = std::getenv("CC");
+    std::string cxx = Sys::findProgram(cxxEnv ? cxxEnv : "c++");
+    std::string cc = Sys::findProgram(ccEnv ? ccEnv : "cc");
+    if (cxx.empty()) {
+        std::cerr << COLOR_RED << "No C++ compiler found on PATH" << COLOR_RESET << std::endl;
+        return false;
+    }
+
+    // Scan sources in a stable order so compile_commands.json does not churn
+    std::vector<fs::path> sources;
+    for (const auto& entry : fs::recursive_directory_iterator(root + "/src")) {
+        if (entry.is_regular_file() && isSource(entry.path())) sources.push_back(entry.path());
+    }
+    std::sort(sources.begin(), sources.end());
+    if (sources.empty()) {
+        std::cerr << COLOR_RED << "No sources found in " << root << "/src" << COLOR_RESET << std::endl;
+        return false;
+    }
+
+    std::vector<Unit> units;
+    for (const auto& source : sources) {
+        Unit unit;
+        unit.source = source;
+        unit.object = fs::path(absBuild) / "obj" / (fs::relative(source, root).string() + ".o");
+        unit.depfile = unit.object.string() + ".d";
+        bool isC = isCSource(source);
+        unit.display = {isC ? cc : cxx};
+        if (!isC && debugMode) unit.display.push_back("-DDEBUG");
+        unit.display.push_back("-I" + root + "/include");
+        if (!isC) unit.display.push_back("-std=gnu++" + std::to_string(cfg.cppVersion));
+        unit.display.insert(unit.display.end(), {"-o", unit.object.string(), "-c", source.string()});
+        unit.args = unit.display;
+        unit.args.insert(unit.args.end() - 4, {"-MMD", "-MF", unit.depfile.string()});
+        Hash::Hasher hasher;
+        for (const auto& arg : unit.args) hasher.update(arg);
+        unit.cmdHash = hasher.hex();
+        units.push_back(std::move(unit));
+    }
+
+    fs::path graphFile = fs::path(absBuild) / GRAPH_FILE;
+    Graph graph = loadGraph(graphFile);
+
+    // A unit is stale if its command changed or any recorded input is newer
+    // than the object. Header mtimes are shared between units, so memoize.
+    std::map<std::string, fs::file_time_type> mtimes;
+    auto mtimeOf = [&](const std::string& file, bool& missing) {
+        auto it = mtimes.find(file);
+        if (it != mtimes.end()) return it->second;
+        std::error_code ec;
+        auto t = fs::last_write_time(file, ec);
+        if (ec) t = fs::file_time_type::max();
+        missing = missing || ec;
+        return mtimes[file] = t;
+    };
+    std::vector<Unit*> stale;
+    for (auto& unit : units) {
+        auto it = graph.units.find(unit.object.string());
+        std::error_code ec;
+        auto objTime = fs::last_write_time(unit.object, ec);
+        bool dirty = ec || it == graph.units.end() || it->second.cmdHash != unit.cmdHash || it->second.deps.empty();
+        for (size_t i = 0; !dirty && i < it->second.deps.size(); ++i) {
+            bool missing = false;
+            dirty = mtimeOf(it->second.deps[i], missing) > objTime || missing;
+        }
+        if (dirty) stale.push_back(&unit);
+    }
+
+    // Forget objects whose sources are gone
+    for (auto it = graph.units.begin(); it != graph.units.end();) {
+        bool known = std::any_of(units.begin(), units.end(),
+                                 [&](const Unit& u) { return u.object.string() == it->first; });
+        if (known) {
+            ++it;
+        } else {
+            std::error_code ec;
+            fs::remove(it->first, ec);
+            it = graph.units.erase(it);
+        }
+    }
+
+    std::mutex mtx;
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    size_t done = 0;
+    CompileCache cache;
+    // Called with mtx held
+    auto record = [&](Unit& unit, const CommandExecutor::Result& result) {
+        ++done;
+        std::cout << COLOR_YELLOW << "[" << done << "/" << stale.size() << "] Compiling "
+                  << fs::relative(unit.source, root).string() << COLOR_RESET << std::endl;
+        std::cerr << result.output;
+        if (result.exitCode != 0) {
+            failed = true;
+            graph.units.erase(unit.object.string());
+            return;
+        }
+        graph.units[unit.object.string()] = {unit.cmdHash, parseDepfile(unit.depfile)};
+    };
+    // The compile cache runs in-process, so it needs threads of its own
+    auto worker = [&]() {
+        for (size_t i = next++; i < stale.size() && !failed; i = next++) {
+            Unit& unit = *stale[i];
+            std::error_code ec;
+            fs::create_directories(unit.object.parent_path(), ec);
+            CommandExecutor::Result result;
+            result.exitCode = cache.exec(root, unit.args);
+            std::lock_guard<std::mutex> lock(mtx);
+            record(unit, result);
+        }
+    };
+    if (!stale.empty()) {
+        unsigned threads = std::max(1u, std::min<unsigned>(jobs, stale.size()));
+        debug::print("Native engine compiling ", stale.size(), " units with ", threads, " jobs");
+        if (useCache) {
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+            worker();
+            for (auto& t : pool) t.join();
+        } else {
+            // Plain compiles are only processes; one event loop drives them all
+            ProcessPool pool(threads);
+            for (Unit* unit : stale) {
+                std::error_code ec;
+                fs::create_directories(unit->object.parent_path(), ec);
+                CommandExecutor::Options options;
+                options.mergeStderr = true;
+                pool.submit(unit->args, options, [&, unit](CommandExecutor::Result result) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (result.cancelled) {
+                        // Killed mid-compile; never trust its object
+                        graph.units.erase(unit->object.string());
+                        return;
+                    }
+                    record(*unit, result);
+                    if (failed) pool.cancelAll();
+                });
+            }
+            pool.wait();
+        }
+    }
+    if (failed) {
+        saveGraph(graphFile, graph);
+        std::cerr << COLOR_RED << "Compilation failed" << COLOR_RESET << std::endl;
+        return false;
+    }
+
+    fs::path binPath = fs::path(absBuild) / cfg.runtimeBin / cfg.projectName;
+    std::vector<std::string> linkArgs = {cxx};
+    for (const auto& unit : units) linkArgs.push_back(unit.object.string());
+    linkArgs.insert(linkArgs.end(), {"-o", binPath.string()});
+    Hash::Hasher linkHasher;
+    for (const auto& arg : linkArgs) linkHasher.update(arg);
+    std::string linkHash = linkHasher.hex();
+
+    std::error_code ec;
+    if (!stale.empty() || linkHash != graph.linkHash || !fs::exists(binPath, ec)) {
+        std::cout << COLOR_YELLOW << "Linking " << cfg.projectName << COLOR_RESET << std::endl;
+        fs::create_directories(binPath.parent_path(), ec);
+        auto result = CommandExecutor::runMerged(linkArgs);
+        std::cerr << result.output;
+        if (result.exitCode != 0) {
+            graph.linkHash.clear();
+            saveGraph(graphFile, graph);
+            std::cerr << COLOR_RED << "Linking failed" << COLOR_RESET << std::endl;
+            return false;
+        }
+        graph.linkHash = linkHash;
+    } else {
+        std::cout << COLOR_GREEN << "Everything up to date." << COLOR_RESET << std::endl;
+    }
+    saveGraph(graphFile, graph);
+
+    // Same shape as CMAKE_EXPORT_COMPILE_COMMANDS output
+    std::ostringstream json;
+    json << "[\n";
+    for (size_t i = 0; i < units.size(); ++i) {
+        const auto& unit = units[i];
+        json << "{\n"
+             << "  \"directory\": \"" << jsonEscape(absBuild) << "\",\n"
+             << "  \"command\": \"" << jsonEscape(joinCommand(unit.display)) << "\",\n"
+             << "  \"file\": \"" << jsonEscape(unit.source.string()) << "\",\n"
+             << "  \"output\": \"" << jsonEscape(unit.object.string()) << "\"\n"
+             << "}" << (i + 1 < units.size() ? "," : "") << "\n";
+    }
+    json << "]";
+    std::ofstream out(absBuild + "/compile_commands.json");
+    out << json.str();
+    return true;
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,252 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "harbour.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+    int group;  // events sharing a non-zero group are scheduled together
+};
+
+constexpr uint64_t cache(uint64_t id, uint64_t result) {
+    return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+const Event EVENTS[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 1},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 1},
+    {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, 2},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 2},
+    {"L1-dcache-loads", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_ACCESS), 3},
+    {"L1-dcache-load-misses", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS), 3},
+    {"LLC-loads", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_ACCESS), 4},
+    {"LLC-load-misses", PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS), 4},
+    {"task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, 0},
+    {"context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, 0},
+    {"cpu-migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, 0},
+    {"page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, 0},
+};
+
+// Order of the derived metrics in reports and files
+const char* DERIVED[] = {"ipc", "branch-miss-rate", "L1-dcache-miss-rate", "LLC-miss-rate"};
+
+int openEvent(const Event& event, pid_t target, int groupFd, bool inherit, bool onExec) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.inherit = inherit;
+    attr.exclude_hv = 1;
+    // Members follow their leader; leaders wait for the exec when asked to
+    attr.disabled = groupFd < 0 && onExec;
+    attr.enable_on_exec = groupFd < 0 && onExec;
+    int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, target, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        // perf_event_paranoid >= 2 only allows counting user space
+        attr.exclude_kernel = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, target, -1, groupFd, PERF_FLAG_FD_CLOEXEC));
+    }
+    return fd;
+}
+
+std::string threadName(pid_t pid, pid_t tid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/task/" + std::to_string(tid) + "/comm");
+    std::string name;
+    std::getline(in, name);
+    return name;
+}
+
+std::string grouped(double value) {
+    std::string digits = std::to_string(static_cast<long long>(value + 0.5));
+    for (int i = static_cast<int>(digits.size()) - 3; i > 0; i -= 3) digits.insert(i, ",");
+    return digits;
+}
+
+} // namespace
+
+PerfCounters::PerfCounters(bool perThread) : perThread(perThread) {}
+
+PerfCounters::~PerfCounters() {
+    for (const auto& c : process) close(c.fd);
+    for (const auto& w : watched)
+        for (const auto& c : w.counters) close(c.fd);
+}
+
+std::vector<PerfCounters::Counter> PerfCounters::open(pid_t target, bool inherit, bool onExec, bool& hardwareOpened) {
+    std::vector<Counter> opened;
+    hardwareOpened = false;
+    for (size_t i = 0; i < std::size(EVENTS);) {
+        // A group opens whole or not at all, so its ratios stay comparable
+        size_t end = i + 1;
+        while (EVENTS[i].group && end < std::size(EVENTS) && EVENTS[end].group == EVENTS[i].group) ++end;
+        std::vector<Counter> group;
+        for (size_t j = i; j < end; ++j) {
+            int fd = openEvent(EVENTS[j], target, group.empty() ? -1 : group.front().fd, inherit, onExec);
+            if (fd < 0) {
+                debug::print("perf_event_open(", EVENTS[j].name, ") failed: ", std::strerror(errno));
+                for (const auto& c : group) close(c.fd);
+                group.clear();
+                break;
+            }
+            group.push_back({EVENTS[j].name, fd});
+        }
+        if (!group.empty() && EVENTS[i].type != PERF_TYPE_SOFTWARE) hardwareOpened = true;
+        opened.insert(opened.end(), group.begin(), group.end());
+        i = end;
+    }
+    return opened;
+}
+
+bool PerfCounters::attach(pid_t target) {
+    pid = target;
+    process = open(target, true, true, hasHardware);
+    if (process.empty()) return false;
+    if (perThread) {
+        bool ignored;
+        watched.push_back({target, open(target, false, true, ignored)});
+        threadCounts.push_back({target, "", {}});
+    }
+    return true;
+}
+
+void PerfCounters::poll() {
+    if (!perThread || pid < 0) return;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator("/proc/" + std::to_string(pid) + "/task", ec)) {
+        pid_t tid = static_cast<pid_t>(std::atoi(entry.path().filename().c_str()));
+        bool known = false;
+        for (auto& t : threadCounts) {
+            if (t.tid != tid) continue;
+            known = true;
+            // Threads usually name themselves after they start
+            std::string name = threadName(pid, tid);
+            if (!name.empty()) t.name = name;
+        }
+        if (known || tid <= 0) continue;
+        bool ignored;
+        auto counters = open(tid, false, false, ignored);
+        if (counters.empty()) continue;
+        watched.push_back({tid, std::move(counters)});
+        threadCounts.push_back({tid, threadName(pid, tid), {}});
+    }
+}
+
+PerfCounters::Counts PerfCounters::read(const std::vector<Counter>& counters) {
+    Counts values;
+    for (const auto& c : counters) {
+        uint64_t data[3] = {0, 0, 0};  // value, time enabled, time running
+        if (::read(c.fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+        double value = static_cast<double>(data[0]);
+        if (data[2] < data[1]) value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        values[c.name] = value;
+    }
+    return values;
+}
+
+void PerfCounters::collect() {
+    counts = read(process);
+    for (size_t i = 0; i < watched.size() && i < threadCounts.size(); ++i) threadCounts[i].counts = read(watched[i].counters);
+}
+
+PerfCounters::Counts PerfCounters::derived(const Counts& counts) {
+    Counts out;
+    auto ratio = [&](const char* name, const char* part, const char* whole) {
+        auto p = counts.find(part), w = counts.find(whole);
+        if (p != counts.end() && w != counts.end() && w->second > 0) out[name] = p->second / w->second;
+    };
+    ratio("ipc", "instructions", "cycles");
+    ratio("branch-miss-rate", "branch-misses", "branches");
+    ratio("L1-dcache-miss-rate", "L1-dcache-load-misses", "L1-dcache-loads");
+    ratio("LLC-miss-rate", "LLC-load-misses", "LLC-loads");
+    return out;
+}
+
+void PerfCounters::report(std::ostream& out) const {
+    out << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+    out << COLOR_YELLOW << "Performance counters"
+        << (hasHardware ? "" : " (software only: hardware counters are unavailable here)") << COLOR_RESET << std::endl;
+    for (const auto& event : EVENTS) {
+        auto it = counts.find(event.name);
+        if (it == counts.end()) continue;
+        if (std::string(event.name) == "task-clock")
+            out << "  " << std::left << std::setw(24) << "task-clock ms" << std::right << std::setw(18) << std::fixed
+                << std::setprecision(3) << it->second / 1e6 << std::defaultfloat << std::endl;
+        else
+            out << "  " << std::left << std::setw(24) << event.name << std::right << std::setw(18)
+                << grouped(it->second) << std::endl;
+    }
+    Counts ratios = derived(counts);
+    for (const char* name : DERIVED) {
+        auto it = ratios.find(name);
+        if (it == ratios.end()) continue;
+        bool rate = std::string(name) != "ipc";
+        out << "  " << std::left << std::setw(24) << name << std::right << std::setw(17) << std::fixed
+            << std::setprecision(2) << (rate ? it->second * 100 : it->second) << (rate ? "%" : " ")
+            << std::defaultfloat << std::endl;
+    }
+    if (!threadCounts.empty()) {
+        out << COLOR_YELLOW << "Per thread:" << COLOR_RESET << std::endl;
+        for (const auto& t : threadCounts) {
+            out << "  " << std::left << std::setw(8) << t.tid << std::setw(18) << t.name << std::right;
+            for (const char* name : {"task-clock", "instructions", "context-switches", "page-faults"}) {
+                auto it = t.counts.find(name);
+                if (it == t.counts.end()) continue;
+                std::string value = std::string(name) == "task-clock"
+                                        ? std::to_string(static_cast<long long>(it->second / 1e6)) + "ms"
+                                        : grouped(it->second);
+                out << "  " << name << "=" << value;
+            }
+            out << std::endl;
+        }
+    }
+    out << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+}
+
+bool PerfCounters::write(const std::string& file) const {
+    std::ofstream out(file);
+    if (!out) return false;
+    out << "# Generated by harbour run --perf\n";
+    out << "hardware=" << (hasHardware ? 1 : 0) << "\n";
+    auto emit = [&](const std::string& prefix, const Counts& values) {
+        for (const auto& event : EVENTS) {
+            auto it = values.find(event.name);
+            if (it != values.end()) out << prefix << event.name << "=" << static_cast<long long>(it->second + 0.5) << "\n";
+        }
+        Counts ratios = derived(values);
+        out << std::setprecision(6);
+        for (const char* name : DERIVED) {
+            auto it = ratios.find(name);
+            if (it != ratios.end()) out << prefix << name << "=" << it->second << "\n";
+        }
+    };
+    emit("", counts);
+    // Numbered in discovery order; tids change from run to run
+    for (size_t i = 0; i < threadCounts.size(); ++i) {
+        std::string prefix = "thread." + std::to_string(i) + ".";
+        out << prefix << "name=" << threadCounts[i].name << "\n";
+        emit(prefix, threadCounts[i].counts);
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -31,13 +31,26 @@ bool ProjectCreator::createProject(const std::string& name, int cppVersion, cons
             stream << "set(SOURCES \n\tsrc/main.cpp\n)\n\n";
             stream << "add_executable(" << name << " ${SOURCES})\n\n";
             if (enableGraphics) {
-                stream << "add_subdirectory(external/glfw)\n";
+                // harbour build links GLFW prebuilt from the artifact cache when it can
+                stream << "if(HARBOUR_GLFW_PREFIX)\n";
+                stream << "    find_package(glfw3 REQUIRED CONFIG PATHS \"${HARBOUR_GLFW_PREFIX}\" NO_DEFAULT_PATH)\n";
+                stream << "else()\n";
+                stream << "    add_subdirectory(external/glfw)\n";
+                stream << "endif()\n";
                 stream << "include_directories(external/glad/GL/include)\n";
                 stream << "include_directories(external/glm)\n";
                 stream << "file(GLOB GLAD_SOURCES external/glad/GL/src/gl.c)\n";
                 stream << "target_sources(" << name << " PRIVATE ${GLAD_SOURCES})\n";
                 stream << "target_link_libraries(" << name << " glfw)\n";
             }
+            // harbour build points this at build/<type>/harbour_pch.hpp
+            stream << "\nif(HARBOUR_PCH_HEADER)\n";
+            stream << "    target_precompile_headers(" << name << " PRIVATE \"$<$<COMPILE_LANGUAGE:CXX>:${HARBOUR_PCH_HEADER}>\")\n";
+            stream << "endif()\n";
+            // Unity batching written by harbour build --unity
+            stream << "\nif(HARBOUR_UNITY_FILE)\n";
+            stream << "    include(${HARBOUR_UNITY_FILE})\n";
+            stream << "endif()\n";
             cmake.close();
         }
         {
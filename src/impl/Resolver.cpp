@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "harbour.hpp"
+#include "hash.hpp"
+#include "json.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream text;
+    text << in.rdbuf();
+    out = text.str();
+    return true;
+}
+
+// What a lockfile was resolved from; order matters as it does in .hrbr
+std::string requirementsKey(const Resolver::Requirements& requirements) {
+    Hash::Hasher hasher;
+    for (const auto& [name, range] : requirements) hasher.update(name).update(range);
+    return hasher.hex();
+}
+
+std::string join(const std::vector<std::string>& names) {
+    std::string out;
+    for (const auto& name : names) out += (out.empty() ? "" : ",") + name;
+    return out;
+}
+
+bool readLock(const std::string& path, const std::string& key, std::vector<Resolver::Package>& packages) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::map<std::string, Resolver::Package> byName;
+    std::string line, lockedKey;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string field = line.substr(0, eq), value = line.substr(eq + 1);
+        if (field == "requirements") {
+            lockedKey = value;
+            continue;
+        }
+        // <package>.<field>=<value>
+        auto dot = field.rfind('.');
+        if (dot == std::string::npos) continue;
+        Resolver::Package& package = byName[field.substr(0, dot)];
+        package.name = field.substr(0, dot);
+        std::string what = field.substr(dot + 1);
+        if (what == "version") package.version = value;
+        else if (what == "url") package.url = value;
+        else if (what == "rev") package.rev = value;
+        else if (what == "dependencies") {
+            std::stringstream names(value);
+            std::string name;
+            while (std::getline(names, name, ','))
+                if (!name.empty()) package.dependencies.push_back(name);
+        }
+    }
+    if (lockedKey != key) return false;
+    packages.clear();
+    for (auto& [name, package] : byName) packages.push_back(std::move(package));
+    return true;
+}
+
+bool writeLock(const std::string& path, const std::string& key, const std::vector<Resolver::Package>& packages) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return false;
+        out << "# Generated by harbour from .hrbr; delete it to resolve again\n";
+        out << "requirements=" << key << "\n";
+        for (const auto& package : packages) {
+            out << package.name << ".version=" << package.version << "\n";
+            out << package.name << ".url=" << package.url << "\n";
+            out << package.name << ".rev=" << package.rev << "\n";
+            out << package.name << ".dependencies=" << join(package.dependencies) << "\n";
+        }
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+} // namespace
+
+Resolver::Resolver(const std::string& indexDir) : indexDir(indexDir.empty() ? defaultIndex() : indexDir) {}
+
+std::string Resolver::defaultIndex() {
+    if (const char* index = std::getenv("HARBOUR_INDEX")) return index;
+    if (const char* home = std::getenv("HOME")) return std::string(home) + "/.harbour/index";
+    return "/tmp/harbour-index";
+}
+
+bool Resolver::readManifest(const std::string& path, Requirements& requirements, std::string& error) {
+    Manifest manifest;
+    if (!manifest.load(path, error)) return false;
+    requirements = std::move(manifest.dependencies);
+    return true;
+}
+
+const std::vector<Resolver::Release>* Resolver::releases(const std::string& name, std::string& error) {
+    auto it = descriptors.find(name);
+    if (it != descriptors.end()) return &it->second;
+
+    std::string path = (fs::path(indexDir) / (name + ".json")).string();
+    std::string text;
+    if (!readFile(path, text)) {
+        error = "package " + name + " is not in the index at " + indexDir;
+        return nullptr;
+    }
+    Json::Value root;
+    std::string parseError;
+    const Json::Value* versions = nullptr;
+    if (!Json::parse(text, root, &parseError) || !(versions = root.find("versions")) || !versions->isObject()) {
+        error = path + ": " + (parseError.empty() ? "expected a \"versions\" object" : parseError);
+        return nullptr;
+    }
+    std::vector<Release> list;
+    for (const auto& [key, entry] : versions->members) {
+        Release release;
+        if (!Semver::parseVersion(Json::unescape(key), release.version) || !entry.isObject()) {
+            debug::print("Skipping malformed release ", Json::unescape(key), " in ", path);
+            continue;
+        }
+        release.url = entry.get("url");
+        release.rev = entry.get("rev", Json::unescape(key));
+        if (const Json::Value* deps = entry.find("dependencies"))
+            for (const auto& [dep, range] : deps->members) release.dependencies.emplace_back(Json::unescape(dep), range.str());
+        list.push_back(std::move(release));
+    }
+    std::sort(list.begin(), list.end(),
+              [](const Release& a, const Release& b) { return b.version < a.version; });
+    return &descriptors.emplace(name, std::move(list)).first->second;
+}
+
+const std::vector<const Resolver::Release*>* Resolver::matching(const std::string& name, const std::string& range,
+                                                                std::string& error) {
+    auto key = std::make_pair(name, range);
+    auto it = candidates.find(key);
+    if (it != candidates.end()) return &it->second;
+    Semver::Range parsed;
+    if (!Semver::parseRange(range, parsed)) {
+        error = "invalid version range \"" + range + "\" for " + name;
+        return nullptr;
+    }
+    const auto* list = releases(name, error);
+    if (!list) return nullptr;
+    std::vector<const Release*> matches;
+    for (const auto& release : *list)
+        if (parsed.satisfies(release.version)) matches.push_back(&release);
+    return &candidates.emplace(key, std::move(matches)).first->second;
+}
+
+// Depth-first over the requirement queue: each package is pinned the first
+// time it is required (newest match first) and later requirements must
+// accept that pin, or the search backs up and tries the next version.
+bool Resolver::solve(std::vector<Pending> queue, size_t next, std::map<std::string, const Release*>& chosen,
+                     std::string& error) {
+    if (next == queue.size()) return true;
+    const Pending req = queue[next];
+    const auto* matches = matching(req.name, req.range, error);
+    if (!matches) return false;
+
+    auto pinned = chosen.find(req.name);
+    if (pinned != chosen.end()) {
+        if (std::find(matches->begin(), matches->end(), pinned->second) != matches->end())
+            return solve(std::move(queue), next + 1, chosen, error);
+        error = req.requiredBy + " needs " + req.name + " " + req.range + ", which conflicts with " + req.name + " " +
+                pinned->second->version.str();
+        return false;
+    }
+    if (matches->empty()) {
+        error = "no version of " + req.name + " matches " + req.range + " (required by " + req.requiredBy + ")";
+        return false;
+    }
+    for (const Release* release : *matches) {
+        chosen[req.name] = release;
+        std::vector<Pending> extended = queue;
+        for (const auto& [dep, range] : release->dependencies)
+            extended.push_back({dep, range, req.name + " " + release->version.str()});
+        if (solve(std::move(extended), next + 1, chosen, error)) return true;
+        chosen.erase(req.name);
+    }
+    return false;
+}
+
+bool Resolver::resolve(const Requirements& requirements, std::vector<Package>& packages, std::string& error) {
+    std::vector<Pending> queue;
+    for (const auto& [name, range] : requirements) queue.push_back({name, range, ".hrbr"});
+    std::map<std::string, const Release*> chosen;
+    if (!solve(std::move(queue), 0, chosen, error)) return false;
+    packages.clear();
+    for (const auto& [name, release] : chosen) {
+        Package package{name, release->version.str(), release->url, release->rev, {}};
+        for (const auto& dep : release->dependencies) package.dependencies.push_back(dep.first);
+        packages.push_back(std::move(package));
+    }
+    return true;
+}
+
+bool Resolver::resolveLocked(const Requirements& requirements, const std::string& lockPath,
+                             std::vector<Package>& packages, std::string& error, bool* fromLock) {
+    std::string key = requirementsKey(requirements);
+    bool locked = readLock(lockPath, key, packages);
+    if (fromLock) *fromLock = locked;
+    if (locked) return true;
+    if (!resolve(requirements, packages, error)) return false;
+    if (!writeLock(lockPath, key, packages)) {
+        error = "cannot write " + lockPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Project
+} // namespace Harbour
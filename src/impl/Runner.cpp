@@ -1,33 +1,37 @@
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <thread>
 #include "harbour.hpp"
 
 namespace Harbour {
 namespace Project {
 
-bool Runner::runProject(const std::string& path) {
-    ConfigManager cfg;
-    if (!cfg.readConfig(path)) return false;
-    std::string releaseBin = path + "/build/release/bin/" + cfg.projectName;
-    std::string debugBin = path + "/build/debug/bin/" + cfg.projectName;
+std::string Runner::newestBinary(const std::string& path, const std::string& projectName) {
+    std::string releaseBin = path + "/build/release/bin/" + projectName;
+    std::string debugBin = path + "/build/debug/bin/" + projectName;
 
     bool hasRelease = std::filesystem::exists(releaseBin);
     bool hasDebug = std::filesystem::exists(debugBin);
 
-    std::string binToRun;
     if (hasRelease && hasDebug) {
         auto tRelease = std::filesystem::last_write_time(releaseBin);
         auto tDebug = std::filesystem::last_write_time(debugBin);
-        if (tDebug > tRelease) {
-            binToRun = debugBin;
-        } else {
-            binToRun = releaseBin;
-        }
+        return tDebug > tRelease ? debugBin : releaseBin;
     } else if (hasDebug) {
-        binToRun = debugBin;
+        return debugBin;
     } else if (hasRelease) {
-        binToRun = releaseBin;
-    } else {
+        return releaseBin;
+    }
+    return "";
+}
+
+bool Runner::runProject(const std::string& path, const RunOptions& runOptions) {
+    ConfigManager cfg;
+    if (!cfg.readConfig(path)) return false;
+    std::string binToRun = newestBinary(path, cfg.projectName);
+    if (binToRun.empty()) {
         std::cerr << COLOR_RED << "No built binary found. Build the project first." << COLOR_RESET << std::endl;
         return false;
     }
@@ -35,10 +39,65 @@ bool Runner::runProject(const std::string& path) {
     std::cout << COLOR_YELLOW << "Running " << binToRun << " ..." << COLOR_RESET << std::endl;
     std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
     Harbour::CommandExecutor exec;
-    auto args = std::vector<std::string>{"/bin/sh", "-c", binToRun};
-    auto result = exec.run(args, true);
+    const std::string& logFile = runOptions.logFile;
+    auto args = std::vector<std::string>{binToRun};
+    // Nothing is captured: without a log the program writes straight to the
+    // terminal, with one its output is forwarded inside the kernel
+    CommandExecutor::Options options;
+    options.capture = false;
+    options.timeoutMs = runOptions.timeoutMs;
+    options.foreground = true;
+    if (!logFile.empty()) {
+        options.teePath = logFile;
+        options.tailBytes = FAILURE_TAIL_BYTES;
+    }
+    PerfCounters counters(runOptions.perfThreads);
+    bool counting = false;
+    std::atomic<bool> exited{false};
+    std::thread threadWatch;
+    if (runOptions.perf) {
+        options.onSpawn = [&](pid_t pid) {
+            counting = counters.attach(pid);
+            if (!counting) {
+                std::cerr << COLOR_RED << "perf_event_open is unavailable; running without counters" << COLOR_RESET
+                          << std::endl;
+            } else if (runOptions.perfThreads) {
+                threadWatch = std::thread([&] {
+                    while (!exited) {
+                        counters.poll();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+                });
+            }
+        };
+    }
+    auto result = exec.run(args, options);
+    exited = true;
+    if (threadWatch.joinable()) threadWatch.join();
+    if (counting) {
+        counters.collect();
+        counters.report(std::cerr);
+        if (!runOptions.perfOutput.empty() && !counters.write(runOptions.perfOutput))
+            std::cerr << COLOR_RED << "Cannot write " << runOptions.perfOutput << COLOR_RESET << std::endl;
+    }
+    debug::print("Run took ", result.wallMs, " ms, ", result.cpuMs, " ms CPU, ", result.maxRssKb, " KiB max RSS");
+    if (result.timedOut) {
+        std::cerr << COLOR_RED << "Program timed out after " << runOptions.timeoutMs << " ms" << COLOR_RESET
+                  << std::endl;
+    }
     if (result.exitCode != 0) {
-        debug::print("Run failed: ", result.error, result.output);
+        debug::print("Run failed with code ", result.exitCode);
+        if (!logFile.empty()) {
+            std::cerr << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+            std::cerr << COLOR_RED << "Program exited with code " << result.exitCode << COLOR_RESET << std::endl;
+            if (!result.error.empty()) {
+                std::cerr << COLOR_YELLOW << (result.truncated ? "Last lines of stderr:" : "stderr:") << COLOR_RESET << std::endl;
+                std::cerr << result.error;
+                if (result.error.back() != '\n') std::cerr << std::endl;
+            }
+            std::cerr << COLOR_YELLOW << "Full output in " << logFile << COLOR_RESET << std::endl;
+            std::cerr << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        }
         return false;
     }
     return true;
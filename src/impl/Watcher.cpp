@@ -0,0 +1,200 @@
+#include <poll.h>
+#include <signal.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include "harbour.hpp"
+
+namespace Harbour {
+namespace Project {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int) { stopRequested = 1; }
+
+// Swap, backup and lock files that editors write next to the real file
+bool isEditorNoise(const std::string& name) {
+    if (name.empty() || name[0] == '.' || name[0] == '#') return true;
+    if (name.back() == '~' || name == "4913") return true;
+    for (const char* ext : {".swp", ".swx", ".tmp"}) {
+        std::string e = ext;
+        if (name.size() > e.size() && name.compare(name.size() - e.size(), e.size(), e) == 0) return true;
+    }
+    return false;
+}
+
+// Stops a build started by spawnBuild, escalating to SIGKILL if the
+// process group does not exit promptly.
+void cancelBuild(pid_t child) {
+    kill(-child, SIGTERM);
+    int status;
+    for (int i = 0; i < 40; ++i) {
+        if (waitpid(child, &status, WNOHANG) == child) {
+            kill(-child, SIGKILL);  // stragglers such as compilers make left behind
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    kill(-child, SIGKILL);
+    waitpid(child, &status, 0);
+}
+
+} // namespace
+
+Watcher::Watcher(std::string path, bool debugMode, BuildOptions options, bool rerun, int debounceMs)
+    : path(std::move(path)), debugMode(debugMode), options(std::move(options)), rerun(rerun), debounceMs(debounceMs) {}
+
+Watcher::~Watcher() {
+    if (fd >= 0) close(fd);
+}
+
+void Watcher::watchTree(const std::string& dir) {
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) return;
+    int wd = inotify_add_watch(fd, dir.c_str(), WATCH_MASK);
+    if (wd >= 0) dirs[wd] = dir;
+    for (const auto& entry : fs::recursive_directory_iterator(dir, ec)) {
+        if (!entry.is_directory(ec)) continue;
+        wd = inotify_add_watch(fd, entry.path().c_str(), WATCH_MASK);
+        if (wd >= 0) dirs[wd] = entry.path().string();
+    }
+}
+
+bool Watcher::start() {
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return false;
+    // The root is watched for the two config files only, so build output
+    // and the compile_commands.json copy never retrigger a build.
+    rootWd = inotify_add_watch(fd, path.c_str(), WATCH_MASK);
+    if (rootWd < 0) return false;
+    watchTree(path + "/src");
+    watchTree(path + "/include");
+    return true;
+}
+
+Watcher::Change Watcher::drain() {
+    Change change = Change::None;
+    alignas(inotify_event) char buf[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        for (char* p = buf; p < buf + n;) {
+            auto* event = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+            std::string name = event->len ? event->name : "";
+            if (event->mask & IN_Q_OVERFLOW) {
+                change = Change::Config;
+            } else if (event->mask & IN_IGNORED) {
+                dirs.erase(event->wd);
+            } else if (event->wd == rootWd) {
+                if (name == "CMakeLists.txt" || name == ".harbourConfig") {
+                    change = Change::Config;
+                } else if ((name == "src" || name == "include") && (event->mask & IN_ISDIR)) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) watchTree(path + "/" + name);
+                    change = std::max(change, Change::Sources);
+                }
+            } else if (dirs.count(event->wd) && !isEditorNoise(name)) {
+                if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+                    watchTree(dirs[event->wd] + "/" + name);
+                change = std::max(change, Change::Sources);
+            }
+        }
+    }
+    return change;
+}
+
+Watcher::Change Watcher::waitForChanges(int timeoutMs) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMs) <= 0) return Change::None;
+    Change change = drain();
+    // Editors and `git checkout` write in bursts; wait for the tree to settle
+    while (poll(&pfd, 1, debounceMs) > 0) change = std::max(change, drain());
+    return change;
+}
+
+int Watcher::spawnBuild(Change change) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        setpgid(0, 0);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        BuildOptions buildOptions = options;
+        buildOptions.reuseConfiguration = change == Change::Sources;
+        Builder builder;
+        int code = 0;
+        if (!builder.buildProject(path, debugMode, false, buildOptions)) {
+            std::cerr << COLOR_RED << "Build failed." << COLOR_RESET << std::endl;
+            code = 1;
+        } else if (rerun) {
+            Runner runner;
+            code = runner.runProject(path) ? 0 : 2;
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(code);
+    }
+    if (pid > 0) setpgid(pid, pid);  // also set here so an early cancel cannot miss the group
+    return pid;
+}
+
+int Watcher::run() {
+    if (!start()) {
+        std::cerr << COLOR_RED << "Could not watch " << path << " (inotify unavailable)" << COLOR_RESET << std::endl;
+        return 1;
+    }
+    struct sigaction action {};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    Change pending = Change::Config;
+    while (!stopRequested) {
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        std::cout << COLOR_YELLOW << (pending == Change::Sources ? "Sources changed, rebuilding..." : "Building...")
+                  << COLOR_RESET << std::endl;
+        std::cout << COLOR_MAGENTA << "==========================================================================" << COLOR_RESET << std::endl;
+        pid_t child = spawnBuild(pending);
+        if (child < 0) {
+            std::cerr << COLOR_RED << "fork() failed" << COLOR_RESET << std::endl;
+            return 1;
+        }
+        Change inFlight = pending;
+        pending = Change::None;
+        while (child > 0 && !stopRequested) {
+            Change change = waitForChanges(100);
+            int status;
+            if (change != Change::None) {
+                // The cancelled build's change still has to be built; a
+                // Config change must not shrink to Sources on the restart
+                pending = std::max(change, inFlight);
+                cancelBuild(child);
+                child = -1;
+                std::cout << COLOR_YELLOW << "Changes detected, restarting" << COLOR_RESET << std::endl;
+            } else if (waitpid(child, &status, WNOHANG) == child) {
+                child = -1;
+                bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                std::cout << (ok ? COLOR_GREEN : COLOR_RED) << (ok ? "Up to date" : "Failed")
+                          << ", watching for changes (Ctrl+C to stop)" << COLOR_RESET << std::endl;
+            }
+        }
+        if (child > 0) cancelBuild(child);
+        while (pending == Change::None && !stopRequested) pending = waitForChanges(-1);
+    }
+    std::cout << COLOR_YELLOW << "Stopped watching." << COLOR_RESET << std::endl;
+    return 0;
+}
+
+} // namespace Project
+} // namespace Harbour
@@ -0,0 +1,68 @@
+#include "hash.hpp"
+#include <fstream>
+#include <string>
+
+namespace Harbour {
+namespace Hash {
+
+namespace {
+constexpr unsigned __int128 makeU128(unsigned long long hi, unsigned long long lo) {
+    return (static_cast<unsigned __int128>(hi) << 64) | lo;
+}
+constexpr unsigned __int128 FNV_OFFSET = makeU128(0x6c62272e07bb0142ULL, 0x62b821756295c58dULL);
+constexpr unsigned __int128 FNV_PRIME = makeU128(0x0000000001000000ULL, 0x000000000000013BULL);
+} // namespace
+
+Hasher::Hasher() : state(FNV_OFFSET) {}
+
+void Hasher::mix(const char *data, size_t size) {
+    unsigned __int128 h = state;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= FNV_PRIME;
+    }
+    state = h;
+}
+
+Hasher &Hasher::update(std::string_view data) {
+    unsigned long long size = data.size();
+    mix(reinterpret_cast<const char *>(&size), sizeof(size));
+    mix(data.data(), data.size());
+    return *this;
+}
+
+Hasher &Hasher::update(long long value) {
+    mix(reinterpret_cast<const char *>(&value), sizeof(value));
+    return *this;
+}
+
+bool Hasher::updateFile(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    char buf[65536];
+    unsigned long long total = 0;
+    while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+        mix(buf, static_cast<size_t>(in.gcount()));
+        total += static_cast<unsigned long long>(in.gcount());
+    }
+    mix(reinterpret_cast<const char *>(&total), sizeof(total));
+    return true;
+}
+
+std::string Hasher::hex() const {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(32, '0');
+    unsigned __int128 h = state;
+    for (int i = 31; i >= 0; --i) {
+        out[i] = digits[static_cast<unsigned>(h & 0xf)];
+        h >>= 4;
+    }
+    return out;
+}
+
+std::string ofString(std::string_view data) {
+    return Hasher().update(data).hex();
+}
+
+} // namespace Hash
+} // namespace Harbour
@@ -0,0 +1,263 @@
+#include "json.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Harbour {
+namespace Json {
+
+namespace {
+
+// Offset of the first byte at or after pos that ends a plain run of string
+// characters: a quote, a backslash or a control character. Sixteen bytes
+// at a time where SSE2 is available (every x86-64 target).
+size_t scanString(std::string_view text, size_t pos) {
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (pos + 16 <= text.size()) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + pos));
+        // Unsigned c <= 0x1F exactly when min(c, 0x1F) == c
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask != 0) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+#endif
+    while (pos < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[pos]);
+        if (c == '"' || c == '\\' || c < 0x20) break;
+        ++pos;
+    }
+    return pos;
+}
+
+class Parser {
+public:
+    explicit Parser(std::string_view text) : text(text) {}
+
+    bool document(Value &out) {
+        skipWs();
+        if (!value(out, 0)) return false;
+        skipWs();
+        if (pos != text.size()) return fail("trailing characters");
+        return true;
+    }
+
+    std::string error;
+
+private:
+    static constexpr int MAX_DEPTH = 512;
+    std::string_view text;
+    size_t pos = 0;
+
+    bool fail(const std::string &what) {
+        if (error.empty()) error = what + " at offset " + std::to_string(pos);
+        return false;
+    }
+
+    void skipWs() {
+        while (pos < text.size() &&
+               (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t'))
+            ++pos;
+    }
+
+    bool literal(std::string_view word) {
+        if (text.substr(pos, word.size()) != word) return fail("invalid literal");
+        pos += word.size();
+        return true;
+    }
+
+    bool value(Value &out, int depth) {
+        if (depth > MAX_DEPTH) return fail("nesting too deep");
+        if (pos >= text.size()) return fail("unexpected end of input");
+        switch (text[pos]) {
+        case '{': return object(out, depth);
+        case '[': return array(out, depth);
+        case '"': out.type = Type::String; return string(out.raw);
+        case 't': out.type = Type::Bool; out.boolean = true; return literal("true");
+        case 'f': out.type = Type::Bool; out.boolean = false; return literal("false");
+        case 'n': out.type = Type::Null; return literal("null");
+        default: return number(out);
+        }
+    }
+
+    bool string(std::string_view &out) {
+        size_t start = ++pos;
+        while ((pos = scanString(text, pos)) < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                out = text.substr(start, pos - start);
+                ++pos;
+                return true;
+            }
+            if (c != '\\') return fail("control character in string");
+            pos += 2;  // the escaped character cannot end the string
+        }
+        return fail("unterminated string");
+    }
+
+    bool number(Value &out) {
+        size_t start = pos;
+        if (pos < text.size() && text[pos] == '-') ++pos;
+        bool digits = false;
+        while (pos < text.size() && ((text[pos] >= '0' && text[pos] <= '9') || text[pos] == '.' ||
+                                     text[pos] == 'e' || text[pos] == 'E' || text[pos] == '+' || text[pos] == '-')) {
+            digits = digits || (text[pos] >= '0' && text[pos] <= '9');
+            ++pos;
+        }
+        if (!digits) return fail("unexpected character");
+        out.type = Type::Number;
+        auto [end, ec] = std::from_chars(text.data() + start, text.data() + pos, out.number);
+        if (ec != std::errc() || end != text.data() + pos) return fail("malformed number");
+        return true;
+    }
+
+    bool array(Value &out, int depth) {
+        out.type = Type::Array;
+        ++pos;
+        skipWs();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            out.items.emplace_back();
+            skipWs();
+            if (!value(out.items.back(), depth + 1)) return false;
+            skipWs();
+            if (pos >= text.size()) return fail("unterminated array");
+            if (text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (text[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool object(Value &out, int depth) {
+        out.type = Type::Object;
+        ++pos;
+        skipWs();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipWs();
+            if (pos >= text.size() || text[pos] != '"') return fail("expected object key");
+            std::string_view key;
+            if (!string(key)) return false;
+            skipWs();
+            if (pos >= text.size() || text[pos] != ':') return fail("expected ':'");
+            ++pos;
+            skipWs();
+            out.members.emplace_back(key, Value());
+            if (!value(out.members.back().second, depth + 1)) return false;
+            skipWs();
+            if (pos >= text.size()) return fail("unterminated object");
+            if (text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (text[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+};
+
+void appendUtf8(std::string &out, unsigned long cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace
+
+std::string unescape(std::string_view raw) {
+    // Most keys and values have no escapes at all
+    size_t first = raw.find('\\');
+    if (first == std::string_view::npos) return std::string(raw);
+    std::string out(raw.substr(0, first));
+    out.reserve(raw.size());
+    for (size_t i = first; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+        char e = raw[++i];
+        switch (e) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+            if (i + 4 >= raw.size()) break;
+            unsigned long cp = std::strtoul(std::string(raw.substr(i + 1, 4)).c_str(), nullptr, 16);
+            i += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                unsigned long low = std::strtoul(std::string(raw.substr(i + 3, 4)).c_str(), nullptr, 16);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+            }
+            appendUtf8(out, cp);
+            break;
+        }
+        default: out += e; break;
+        }
+    }
+    return out;
+}
+
+const Value *Value::find(std::string_view key) const {
+    if (type != Type::Object) return nullptr;
+    for (const auto &[k, v] : members)
+        if (k == key) return &v;
+    return nullptr;
+}
+
+std::string Value::str() const { return type == Type::String ? unescape(raw) : ""; }
+
+std::string Value::get(std::string_view key, const std::string &fallback) const {
+    const Value *v = find(key);
+    return v && v->isString() ? v->str() : fallback;
+}
+
+bool parse(std::string_view text, Value &out, std::string *error) {
+    Parser parser(text);
+    out = Value();
+    bool ok = parser.document(out);
+    if (!ok && error) *error = parser.error;
+    return ok;
+}
+
+} // namespace Json
+} // namespace Harbour
@@ -0,0 +1,32 @@
+#include "numbers.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace Harbour {
+namespace Numbers {
+
+bool parseInteger(std::string_view text, long long min, long long max, long long &out) {
+    // from_chars takes a leading '-' but never a '+'
+    if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+    if (text.empty() || (text[0] == '-' && min >= 0)) return false;
+    long long value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size() || value < min || value > max) return false;
+    out = value;
+    return true;
+}
+
+bool parseDecimal(std::string_view text, double min, double max, double &out) {
+    if (!text.empty() && text[0] == '+') text.remove_prefix(1);
+    if (text.empty()) return false;
+    double value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, std::chars_format::fixed);
+    if (ec != std::errc() || end != text.data() + text.size() || !std::isfinite(value) || value < min ||
+        value > max)
+        return false;
+    out = value;
+    return true;
+}
+
+} // namespace Numbers
+} // namespace Harbour
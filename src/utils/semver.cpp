@@ -0,0 +1,194 @@
+#include "semver.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace Harbour {
+namespace Semver {
+
+namespace {
+
+bool number(std::string_view &text, long &out) {
+    size_t i = 0;
+    while (i < text.size() && std::isdigit(static_cast<unsigned char>(text[i]))) ++i;
+    if (i == 0 || i > 9) return false;
+    out = std::strtol(std::string(text.substr(0, i)).c_str(), nullptr, 10);
+    text.remove_prefix(i);
+    return true;
+}
+
+// Prerelease and build suffixes after MAJOR.MINOR.PATCH
+bool suffix(std::string_view text, Version &out) {
+    if (!text.empty() && text[0] == '-') {
+        auto plus = text.find('+');
+        out.prerelease = std::string(text.substr(1, plus == std::string_view::npos ? std::string_view::npos : plus - 1));
+        if (out.prerelease.empty()) return false;
+        text = plus == std::string_view::npos ? std::string_view() : text.substr(plus);
+    }
+    return text.empty() || (text[0] == '+' && text.size() > 1);
+}
+
+// A version with trailing components missing or wildcarded (1, 1.2, 1.2.x,
+// *); parts says how many were given.
+bool partial(std::string_view text, Version &out, int &parts) {
+    out = Version();
+    parts = 0;
+    if (!text.empty() && (text[0] == 'v' || text[0] == '=')) text.remove_prefix(1);
+    long *fields[] = {&out.major, &out.minor, &out.patch};
+    while (parts < 3) {
+        if (text.empty()) return true;
+        if (text[0] == 'x' || text[0] == 'X' || text[0] == '*') {
+            text.remove_prefix(1);
+            return text.empty();
+        }
+        if (!number(text, *fields[parts])) return false;
+        ++parts;
+        if (parts < 3 && !text.empty() && text[0] == '.') text.remove_prefix(1);
+        else break;
+    }
+    if (parts == 3) return suffix(text, out);
+    return text.empty();
+}
+
+// Whitespace-separated comparators; a bare operator (">= 1.2.3") is joined
+// to the version after it
+std::vector<std::string> tokens(std::string_view group) {
+    std::vector<std::string> out;
+    bool pendingOp = false;
+    size_t pos = 0;
+    while ((pos = group.find_first_not_of(" \t", pos)) != std::string_view::npos) {
+        size_t end = std::min(group.find_first_of(" \t", pos), group.size());
+        std::string token(group.substr(pos, end - pos));
+        if (pendingOp) out.back() += token;
+        else out.push_back(token);
+        pendingOp = token.find_first_not_of("<>=^~") == std::string::npos;
+        pos = end;
+    }
+    return out;
+}
+
+int compareIdentifiers(std::string_view a, std::string_view b) {
+    bool numA = !a.empty() && a.find_first_not_of("0123456789") == std::string_view::npos;
+    bool numB = !b.empty() && b.find_first_not_of("0123456789") == std::string_view::npos;
+    if (numA && numB) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        return a.compare(b) < 0 ? -1 : a.compare(b) > 0 ? 1 : 0;
+    }
+    if (numA != numB) return numA ? -1 : 1;
+    return a.compare(b) < 0 ? -1 : a.compare(b) > 0 ? 1 : 0;
+}
+
+} // namespace
+
+std::string Version::str() const {
+    std::string out = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+    return prerelease.empty() ? out : out + "-" + prerelease;
+}
+
+int Version::compare(const Version &other) const {
+    if (major != other.major) return major < other.major ? -1 : 1;
+    if (minor != other.minor) return minor < other.minor ? -1 : 1;
+    if (patch != other.patch) return patch < other.patch ? -1 : 1;
+    if (prerelease.empty() || other.prerelease.empty()) {
+        if (prerelease.empty() == other.prerelease.empty()) return 0;
+        return prerelease.empty() ? 1 : -1;  // 1.0.0-rc < 1.0.0
+    }
+    std::string_view a = prerelease, b = other.prerelease;
+    while (true) {
+        auto dotA = a.find('.'), dotB = b.find('.');
+        int c = compareIdentifiers(a.substr(0, dotA), b.substr(0, dotB));
+        if (c != 0) return c;
+        if (dotA == std::string_view::npos || dotB == std::string_view::npos)
+            return dotA == dotB ? 0 : dotA == std::string_view::npos ? -1 : 1;
+        a.remove_prefix(dotA + 1);
+        b.remove_prefix(dotB + 1);
+    }
+}
+
+bool parseVersion(std::string_view text, Version &out) {
+    int parts = 0;
+    return partial(text, out, parts) && parts == 3;
+}
+
+bool parseRange(std::string_view text, Range &out) {
+    using Op = Range::Op;
+    out = Range();
+    out.text = std::string(text);
+    while (true) {
+        auto bar = text.find("||");
+        std::string_view group = text.substr(0, bar);
+        std::vector<Range::Comparator> set;
+        for (const auto &token : tokens(group)) {
+            size_t opLen = std::min(token.find_first_not_of("<>=^~"), token.size());
+            std::string op = token.substr(0, opLen);
+            Version v;
+            int parts = 0;
+            if (!partial(std::string_view(token).substr(opLen), v, parts)) return false;
+            auto bump = [&](int at) {
+                Version up;
+                if (at == 0) up.major = v.major + 1;
+                else if (at == 1) up = Version{v.major, v.minor + 1, 0, ""};
+                else up = Version{v.major, v.minor, v.patch + 1, ""};
+                return up;
+            };
+            if (op == "^") {
+                if (parts == 0) continue;
+                set.push_back({Op::Ge, v});
+                int at = v.major > 0 || parts == 1 ? 0 : v.minor > 0 || parts == 2 ? 1 : 2;
+                set.push_back({Op::Lt, bump(at)});
+            } else if (op == "~") {
+                if (parts == 0) continue;
+                set.push_back({Op::Ge, v});
+                set.push_back({Op::Lt, bump(parts == 1 ? 0 : 1)});
+            } else if (op.empty() || op == "=") {
+                if (parts == 3) set.push_back({Op::Eq, v});
+                else if (parts > 0) {
+                    set.push_back({Op::Ge, v});
+                    set.push_back({Op::Lt, bump(parts - 1)});
+                }
+            } else if (op == ">=") {
+                set.push_back({Op::Ge, v});
+            } else if (op == ">") {
+                if (parts == 3) set.push_back({Op::Gt, v});
+                else if (parts > 0) set.push_back({Op::Ge, bump(parts - 1)});
+                else set.push_back({Op::Lt, Version()});  // >*: nothing
+            } else if (op == "<=") {
+                if (parts == 3) set.push_back({Op::Le, v});
+                else if (parts > 0) set.push_back({Op::Lt, bump(parts - 1)});
+            } else if (op == "<") {
+                set.push_back({Op::Lt, v});
+            } else {
+                return false;
+            }
+        }
+        out.sets.push_back(std::move(set));
+        if (bar == std::string_view::npos) break;
+        text.remove_prefix(bar + 2);
+    }
+    return true;
+}
+
+bool Range::satisfies(const Version &version) const {
+    for (const auto &set : sets) {
+        bool ok = true, prereleaseAllowed = version.prerelease.empty();
+        for (const auto &c : set) {
+            int cmp = version.compare(c.version);
+            switch (c.op) {
+            case Op::Eq: ok = cmp == 0; break;
+            case Op::Lt: ok = cmp < 0; break;
+            case Op::Le: ok = cmp <= 0; break;
+            case Op::Gt: ok = cmp > 0; break;
+            case Op::Ge: ok = cmp >= 0; break;
+            }
+            if (!ok) break;
+            if (!c.version.prerelease.empty() && c.version.major == version.major &&
+                c.version.minor == version.minor && c.version.patch == version.patch)
+                prereleaseAllowed = true;
+        }
+        if (ok && prereleaseAllowed) return true;
+    }
+    return false;
+}
+
+} // namespace Semver
+} // namespace Harbour
@@ -0,0 +1,69 @@
+#include "stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Harbour {
+namespace Stats {
+
+double median(std::vector<double> samples) {
+  if (samples.empty()) return 0;
+  size_t mid = samples.size() / 2;
+  std::nth_element(samples.begin(), samples.begin() + mid, samples.end());
+  double upper = samples[mid];
+  if (samples.size() % 2) return upper;
+  double lower = *std::max_element(samples.begin(), samples.begin() + mid);
+  return (lower + upper) / 2;
+}
+
+double mad(const std::vector<double> &samples) {
+  double center = median(samples);
+  std::vector<double> deviations;
+  deviations.reserve(samples.size());
+  for (double s : samples) deviations.push_back(std::fabs(s - center));
+  return median(std::move(deviations));
+}
+
+Interval medianInterval(std::vector<double> samples, double z) {
+  if (samples.empty()) return {};
+  std::sort(samples.begin(), samples.end());
+  // The rank of the median is Binomial(n, 1/2): mean n/2, sd sqrt(n)/2
+  double n = static_cast<double>(samples.size());
+  double spread = z * std::sqrt(n) / 2;
+  long low = static_cast<long>(std::floor(n / 2 - spread));
+  long high = static_cast<long>(std::ceil(n / 2 + spread)) - 1;
+  low = std::clamp(low, 0L, static_cast<long>(samples.size()) - 1);
+  high = std::clamp(high, 0L, static_cast<long>(samples.size()) - 1);
+  return {samples[low], samples[high]};
+}
+
+double probabilityGreater(const std::vector<double> &before, const std::vector<double> &after) {
+  if (before.empty() || after.empty()) return 1;
+  // Rank the pooled samples, giving ties their average rank
+  std::vector<std::pair<double, bool>> pooled;
+  for (double s : before) pooled.emplace_back(s, false);
+  for (double s : after) pooled.emplace_back(s, true);
+  std::sort(pooled.begin(), pooled.end());
+  double rankSum = 0, tieTerm = 0;
+  for (size_t i = 0; i < pooled.size();) {
+    size_t j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+    double rank = (i + 1 + j) / 2.0;
+    for (size_t k = i; k < j; ++k)
+      if (pooled[k].second) rankSum += rank;
+    double t = static_cast<double>(j - i);
+    tieTerm += t * t * t - t;
+    i = j;
+  }
+  double n1 = static_cast<double>(after.size()), n2 = static_cast<double>(before.size());
+  double n = n1 + n2;
+  double u = rankSum - n1 * (n1 + 1) / 2;
+  double variance = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+  if (variance <= 0) return 1;  // every sample tied
+  // Continuity-corrected upper tail of the normal approximation
+  double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+} // namespace Stats
+} // namespace Harbour
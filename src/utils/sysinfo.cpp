@@ -0,0 +1,108 @@
+#include "sysinfo.hpp"
+#include <sched.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace Harbour {
+namespace Sys {
+
+namespace {
+
+// Reads the cgroup the process belongs to from /proc/self/cgroup. Returns
+// the path for the unified (v2) hierarchy, or for the "cpu" controller on v1.
+std::string cgroupPath(bool unified) {
+    std::ifstream in("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(in, line)) {
+        auto first = line.find(':');
+        auto second = line.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) continue;
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        if (unified && line.compare(0, first, "0") == 0 && controllers.empty())
+            return line.substr(second + 1);
+        if (!unified) {
+            std::stringstream ss(controllers);
+            std::string c;
+            while (std::getline(ss, c, ','))
+                if (c == "cpu") return line.substr(second + 1);
+        }
+    }
+    return "";
+}
+
+// CPU quota in cores (may be fractional), or 0 when unlimited/unknown.
+double cgroupQuota() {
+    // cgroup v2: "<quota> <period>" or "max <period>"
+    for (const std::string &base : {std::string("/sys/fs/cgroup") + cgroupPath(true),
+                                    std::string("/sys/fs/cgroup")}) {
+        std::ifstream in(base + "/cpu.max");
+        std::string quota;
+        long period = 0;
+        if (in >> quota >> period) {
+            if (quota == "max" || period <= 0) return 0;
+            return std::stod(quota) / static_cast<double>(period);
+        }
+    }
+    // cgroup v1: cpu.cfs_quota_us / cpu.cfs_period_us
+    std::string v1 = cgroupPath(false);
+    for (const std::string &base : {"/sys/fs/cgroup/cpu" + v1, std::string("/sys/fs/cgroup/cpu"),
+                                    "/sys/fs/cgroup/cpu,cpuacct" + v1}) {
+        std::ifstream q(base + "/cpu.cfs_quota_us"), p(base + "/cpu.cfs_period_us");
+        long quota = 0, period = 0;
+        if (q >> quota && p >> period) {
+            if (quota <= 0 || period <= 0) return 0;
+            return static_cast<double>(quota) / static_cast<double>(period);
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+std::string cgroupDir() {
+    for (const std::string base : {"/sys/fs/cgroup", "/sys/fs/cgroup/unified"}) {
+        if (std::filesystem::exists(base + "/cgroup.controllers")) return base + cgroupPath(true);
+    }
+    return "";
+}
+
+unsigned usableCores() {
+    unsigned cores = 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) cores = CPU_COUNT(&set);
+    if (cores == 0) cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    double quota = cgroupQuota();
+    if (quota > 0) {
+        unsigned limit = static_cast<unsigned>(std::ceil(quota));
+        if (limit >= 1 && limit < cores) cores = limit;
+    }
+    return cores;
+}
+
+std::string findProgram(const std::string &name) {
+    if (name.find('/') != std::string::npos)
+        return access(name.c_str(), X_OK) == 0 ? name : "";
+    const char *path = std::getenv("PATH");
+    if (!path) return "";
+    std::stringstream ss(path);
+    std::string dir;
+    while (std::getline(ss, dir, ':')) {
+        if (dir.empty()) dir = ".";
+        std::string candidate = dir + "/" + name;
+        if (access(candidate.c_str(), X_OK) == 0 && !std::filesystem::is_directory(candidate))
+            return candidate;
+    }
+    return "";
+}
+
+} // namespace Sys
+} // namespace Harbour
@@ -0,0 +1,127 @@
+#include "trace.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+namespace Harbour {
+namespace Trace {
+
+namespace {
+
+// Small stable ids read better in trace viewers than hashed thread ids
+unsigned currentTid() {
+    static std::mutex idMtx;
+    static std::map<std::thread::id, unsigned> ids;
+    std::lock_guard<std::mutex> lock(idMtx);
+    auto it = ids.find(std::this_thread::get_id());
+    if (it != ids.end()) return it->second;
+    unsigned id = static_cast<unsigned>(ids.size()) + 1;
+    ids[std::this_thread::get_id()] = id;
+    return id;
+}
+
+std::string jsonEscape(const std::string &s) {
+    std::string out;
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) continue;
+            out += c;
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+Recorder::Recorder() : origin(std::chrono::steady_clock::now()) {}
+
+Recorder &Recorder::instance() {
+    static Recorder recorder;
+    return recorder;
+}
+
+long long Recorder::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin)
+        .count();
+}
+
+void Recorder::record(Event event) {
+    std::lock_guard<std::mutex> lock(mtx);
+    recorded.push_back(std::move(event));
+}
+
+std::vector<Event> Recorder::events() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return recorded;
+}
+
+void Recorder::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    recorded.clear();
+}
+
+bool Recorder::writeChromeTrace(const std::filesystem::path &path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    auto snapshot = events();
+    out.precision(15);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        const auto &e = snapshot[i];
+        out << "{\"name\":\"" << jsonEscape(e.name) << "\",\"cat\":\"" << jsonEscape(e.category)
+            << "\",\"ph\":\"X\",\"ts\":" << e.startUs << ",\"dur\":" << e.durationUs
+            << ",\"pid\":" << getpid() << ",\"tid\":" << e.tid;
+        if (!e.args.empty()) {
+            out << ",\"args\":{";
+            for (size_t a = 0; a < e.args.size(); ++a)
+                out << (a ? "," : "") << "\"" << jsonEscape(e.args[a].first) << "\":" << e.args[a].second;
+            out << "}";
+        }
+        out << "}" << (i + 1 < snapshot.size() ? "," : "") << "\n";
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+}
+
+void Recorder::printSummary(std::ostream &out, const std::string &category) const {
+    auto snapshot = events();
+    std::sort(snapshot.begin(), snapshot.end(), [](const Event &a, const Event &b) { return a.startUs < b.startUs; });
+    std::map<std::string, std::pair<size_t, long long>> totals;
+    for (const auto &e : snapshot) {
+        auto &t = totals[e.category];
+        ++t.first;
+        t.second += e.durationUs;
+        if (e.category == category)
+            out << "  " << std::left << std::setw(40) << e.name.substr(0, 39) << std::right << std::fixed
+                << std::setprecision(3) << std::setw(10) << e.durationUs / 1e6 << " s\n";
+    }
+    for (const auto &[cat, t] : totals) {
+        if (cat == category) continue;
+        out << "  " << std::left << std::setw(40) << (std::to_string(t.first) + " x " + cat) << std::right
+            << std::fixed << std::setprecision(3) << std::setw(10) << t.second / 1e6 << " s\n";
+    }
+}
+
+Scope::Scope(std::string name, std::string category)
+    : name(std::move(name)), category(std::move(category)), start(Recorder::instance().nowUs()) {}
+
+void Scope::arg(std::string key, double value) {
+    args.emplace_back(std::move(key), value);
+}
+
+Scope::~Scope() {
+    auto &recorder = Recorder::instance();
+    recorder.record(
+        {std::move(name), std::move(category), start, recorder.nowUs() - start, currentTid(), std::move(args)});
+}
+
+} // namespace Trace
+} // namespace Harbour
@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_ARTIFACT_ROOT = "mock_artifact_cache";
+
+void cleanupMockArtifacts() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_ARTIFACT_ROOT, ec);
+}
+
+// A static C library that installs an exported `mini` target, the way GLFW does
+std::string createMockLibrary() {
+    auto lib = std::filesystem::absolute(MOCK_ARTIFACT_ROOT / "mini");
+    std::filesystem::create_directories(lib);
+    std::ofstream(lib / "mini.c") << "int mini_answer(void) { return 42; }\n";
+    std::ofstream(lib / "CMakeLists.txt")
+        << "cmake_minimum_required(VERSION 3.16)\nproject(mini C)\n"
+           "add_library(mini mini.c)\n"
+           "install(TARGETS mini EXPORT miniTargets ARCHIVE DESTINATION lib)\n"
+           "install(EXPORT miniTargets FILE miniConfig.cmake DESTINATION lib/cmake/mini)\n";
+    return lib.string();
+}
+
+bool test_builds_once_and_imports() {
+    std::cout << "--- Test: Builds Once And Imports ---\n";
+    cleanupMockArtifacts();
+    std::string lib = createMockLibrary();
+    Harbour::Project::ArtifactCache cache((MOCK_ARTIFACT_ROOT / "cache").string());
+    std::string error;
+    std::string prefix = cache.ensure("mini", lib, "Release", {}, 1, error);
+    auto archive = std::filesystem::path(prefix) / "lib" / "libmini.a";
+    if (prefix.empty() || !std::filesystem::exists(archive)) {
+        std::cerr << "FAIL: Library was not built into the cache: " << error << "\n";
+        return false;
+    }
+    auto built = std::filesystem::last_write_time(archive);
+    if (cache.ensure("mini", lib, "Release", {}, 1, error) != prefix ||
+        std::filesystem::last_write_time(archive) != built) {
+        std::cerr << "FAIL: Second ensure rebuilt the entry.\n";
+        return false;
+    }
+
+    // A consumer links the cached archive through the imported target
+    auto app = std::filesystem::absolute(MOCK_ARTIFACT_ROOT / "app");
+    std::filesystem::create_directories(app);
+    std::ofstream(app / "main.c") << "int mini_answer(void);\nint main(void) { return mini_answer() != 42; }\n";
+    std::ofstream(app / "CMakeLists.txt")
+        << "cmake_minimum_required(VERSION 3.16)\nproject(app C)\n"
+           "find_package(mini REQUIRED CONFIG PATHS \"${MINI_PREFIX}\" NO_DEFAULT_PATH)\n"
+           "add_executable(app main.c)\ntarget_link_libraries(app mini)\n";
+    std::string cmd = "cmake -S '" + app.string() + "' -B '" + (app / "build").string() + "' -DMINI_PREFIX='" +
+                      prefix + "' >/dev/null && cmake --build '" + (app / "build").string() + "' >/dev/null && '" +
+                      (app / "build" / "app").string() + "'";
+    if (std::system(cmd.c_str()) != 0) {
+        std::cerr << "FAIL: Consumer could not link the imported target.\n";
+        return false;
+    }
+    std::cout << "PASS: Built once, reused, and linked through an imported target.\n";
+    return true;
+}
+
+bool test_key_inputs() {
+    std::cout << "--- Test: Key Inputs ---\n";
+    cleanupMockArtifacts();
+    std::string lib = createMockLibrary();
+    using Harbour::Project::ArtifactCache;
+    std::string base = ArtifactCache::key(lib, "Release", {});
+    bool ok = ArtifactCache::key(lib, "Release", {}) == base;
+    ok &= ArtifactCache::key(lib, "Debug", {}) != base;
+    ok &= ArtifactCache::key(lib, "Release", {"-DMINI_OPTION=ON"}) != base;
+    setenv("CFLAGS", "-O1", 1);
+    ok &= ArtifactCache::key(lib, "Release", {}) != base;
+    unsetenv("CFLAGS");
+    std::ofstream(std::filesystem::path(lib) / "mini.c", std::ios::app) << "/* edited */\n";
+    std::string edited = ArtifactCache::key(lib, "Release", {});
+    ok &= edited != base;
+    std::ofstream(std::filesystem::path(lib) / ArtifactCache::REVISION_FILE) << "0123abcd\n";
+    ok &= ArtifactCache::sourceRevision(lib) == "0123abcd" && ArtifactCache::key(lib, "Release", {}) != edited;
+    if (!ok) {
+        std::cerr << "FAIL: Key did not track build type, options, flags and revision.\n";
+        return false;
+    }
+    std::cout << "PASS: Key changes with build type, options, CFLAGS and revision.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running ArtifactCache Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_builds_once_and_imports();
+    all_ok &= test_key_inputs();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All ArtifactCache tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME ARTIFACTCACHE TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockArtifacts();
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+namespace fs = std::filesystem;
+
+const fs::path MOCK_PROJECT_ROOT = "mock_bench_project";
+
+void createProject(const std::string &body) {
+    fs::remove_all(MOCK_PROJECT_ROOT);
+    fs::create_directories(MOCK_PROJECT_ROOT / "build" / "release" / "bin");
+    std::ofstream(MOCK_PROJECT_ROOT / ".harbourConfig") << "project_name=\"MockApp\"\nruntime_bin=\"bin\"\n";
+    fs::path bin = MOCK_PROJECT_ROOT / "build" / "release" / "bin" / "MockApp";
+    std::ofstream(bin) << "#!/bin/sh\n" << body << "\n";
+    fs::permissions(bin, fs::perms::owner_all, fs::perm_options::add);
+}
+
+Harbour::Project::Bencher::Sample sample(double wallMs, double maxRssKb = 1000) {
+    Harbour::Project::Bencher::Sample s;
+    s.wallMs = wallMs;
+    s.userMs = wallMs / 2;
+    s.maxRssKb = maxRssKb;
+    return s;
+}
+
+bool test_measure() {
+    std::cout << "--- Test: Measure One Run ---\n";
+    createProject("echo noisy; exit 0");
+    Harbour::Project::Bencher::Sample s;
+    std::string error;
+    std::string bin = (MOCK_PROJECT_ROOT / "build" / "release" / "bin" / "MockApp").string();
+    if (!Harbour::Project::Bencher::measure(bin, {}, s, error) || s.wallMs <= 0 || s.maxRssKb <= 0) {
+        std::cerr << "FAIL: No wall time or RSS measured (" << error << ").\n";
+        return false;
+    }
+    createProject("exit 4");
+    if (Harbour::Project::Bencher::measure(bin, {}, s, error) || error.find("code 4") == std::string::npos) {
+        std::cerr << "FAIL: A failing run was not reported.\n";
+        return false;
+    }
+    std::cout << "PASS: wait4 rusage recorded and failures reported.\n";
+    return true;
+}
+
+bool test_regressions() {
+    std::cout << "--- Test: Regression Detection ---\n";
+    std::vector<Harbour::Project::Bencher::Sample> before, noise, slower, bigger;
+    for (int i = 0; i < 10; ++i) {
+        before.push_back(sample(100 + i % 3));
+        noise.push_back(sample(100 + (i + 1) % 3));
+        slower.push_back(sample(130 + i % 3));
+        bigger.push_back(sample(100 + i % 3, 2000));
+    }
+    using Harbour::Project::Bencher;
+    auto slow = Bencher::regressions(before, slower, 0.05);
+    if (!Bencher::regressions(before, noise, 0.05).empty() || slow.size() != 2 || slow[0].metric != "wall ms" ||
+        slow[1].metric != "cpu ms") {
+        std::cerr << "FAIL: Expected wall and CPU time regressions only for the slower samples.\n";
+        return false;
+    }
+    auto rss = Bencher::regressions(before, bigger, 0.05);
+    if (rss.size() != 1 || rss[0].metric != "max rss KiB" || !Bencher::regressions(before, slower, 0.5).empty()) {
+        std::cerr << "FAIL: RSS growth or the threshold was not honoured.\n";
+        return false;
+    }
+    std::cout << "PASS: Significant slowdowns flagged, noise ignored.\n";
+    return true;
+}
+
+bool test_baseline_round_trip() {
+    std::cout << "--- Test: Baseline Save And Compare ---\n";
+    createProject("exit 0");
+    Harbour::Project::Bencher bencher;
+    Harbour::Project::BenchOptions options;
+    options.runs = 5;
+    options.warmups = 1;
+    options.save = "main";
+    std::string file = Harbour::Project::Bencher::baselinePath(MOCK_PROJECT_ROOT.string(), "main");
+    Harbour::Project::Bencher::Baseline baseline;
+    if (!bencher.benchProject(MOCK_PROJECT_ROOT.string(), options) ||
+        !Harbour::Project::Bencher::loadBaseline(file, baseline) || baseline.samples.size() != 5) {
+        std::cerr << "FAIL: Baseline was not stored under build/bench.\n";
+        return false;
+    }
+    // A baseline ten times faster than anything possible must fail the compare
+    for (auto &s : baseline.samples) {
+        s.wallMs /= 10;
+        s.userMs /= 10;
+        s.sysMs /= 10;
+    }
+    Harbour::Project::Bencher::saveBaseline(file, baseline);
+    options.save.clear();
+    options.compare = "main";
+    if (bencher.benchProject(MOCK_PROJECT_ROOT.string(), options)) {
+        std::cerr << "FAIL: Compare passed against a much faster baseline.\n";
+        return false;
+    }
+    options.compare = "missing";
+    if (bencher.benchProject(MOCK_PROJECT_ROOT.string(), options)) {
+        std::cerr << "FAIL: Compare passed without a baseline.\n";
+        return false;
+    }
+    std::cout << "PASS: Baseline stored, and a regression fails the run.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running Bencher Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_measure();
+    all_ok &= test_regressions();
+    all_ok &= test_baseline_round_trip();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Bencher tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME BENCHER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    fs::remove_all(MOCK_PROJECT_ROOT);
+    return all_ok ? 0 : 1;
+}
@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
@@ -38,10 +39,209 @@ bool test_build_failure() {
     return true;
 }
 
+bool test_unknown_generator() {
+    std::cout << "--- Test: Unknown Generator ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "bogus";
+    bool result = builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options);
+    if (result || std::filesystem::exists(MOCK_PROJECT_ROOT / "build")) {
+        std::cerr << "FAIL: Build went ahead with an unknown generator.\n";
+        return false;
+    }
+    std::cout << "PASS: Correctly rejected an unknown generator.\n";
+    return true;
+}
+
+void createMockSources(const std::string& projectName) {
+    std::filesystem::create_directories(MOCK_PROJECT_ROOT / "src");
+    std::ofstream cmake(MOCK_PROJECT_ROOT / "CMakeLists.txt");
+    cmake << "cmake_minimum_required(VERSION 3.16)\n";
+    cmake << "project(" << projectName << " LANGUAGES CXX)\n";
+    cmake << "set(CMAKE_EXPORT_COMPILE_COMMANDS ON)\n";
+    cmake << "set(CMAKE_RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/bin)\n";
+    cmake << "add_executable(" << projectName << " src/main.cpp)\n";
+    cmake.close();
+    std::ofstream main(MOCK_PROJECT_ROOT / "src" / "main.cpp");
+    main << "int main() { return 0; }\n";
+    main.close();
+}
+
+bool test_configure_skipped_when_unchanged() {
+    std::cout << "--- Test: Configure Skipped When Unchanged ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    createMockSources("MockBuilderApp");
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "make";
+    // Rewritten only when Builder actually runs the configure step
+    const auto stamp = MOCK_PROJECT_ROOT / "build" / "release" / ".harbour-configure";
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Initial build failed.\n";
+        return false;
+    }
+    auto firstConfigure = std::filesystem::last_write_time(stamp);
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Second build failed.\n";
+        return false;
+    }
+    if (std::filesystem::last_write_time(stamp) != firstConfigure) {
+        std::cerr << "FAIL: CMake re-configured although nothing changed.\n";
+        return false;
+    }
+    std::ofstream(MOCK_PROJECT_ROOT / ".harbourConfig", std::ios::app) << "build_jobs=\"1\"\n";
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Build after config change failed.\n";
+        return false;
+    }
+    if (std::filesystem::last_write_time(stamp) == firstConfigure) {
+        std::cerr << "FAIL: CMake did not re-configure after .harbourConfig changed.\n";
+        return false;
+    }
+    std::cout << "PASS: Configure ran only when its inputs changed.\n";
+    return true;
+}
+
+bool test_auto_pch_header() {
+    std::cout << "--- Test: Automatic PCH Header ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    createMockSources("MockBuilderApp");
+    std::ofstream(MOCK_PROJECT_ROOT / ".harbourConfig", std::ios::app) << "precompiled_headers=\"auto\"\n";
+    std::ofstream(MOCK_PROJECT_ROOT / "src" / "main.cpp") << "#include <vector>\nint main() { return std::vector<int>().size(); }\n";
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "make";
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Build with precompiled headers failed.\n";
+        return false;
+    }
+    std::ifstream pch(MOCK_PROJECT_ROOT / "build" / "release" / "harbour_pch.hpp");
+    std::string content((std::istreambuf_iterator<char>(pch)), std::istreambuf_iterator<char>());
+    if (content.find("#include <vector>") == std::string::npos) {
+        std::cerr << "FAIL: Frequently included header missing from the PCH.\n";
+        return false;
+    }
+    std::cout << "PASS: PCH header generated from the most included headers.\n";
+    return true;
+}
+
+bool test_unity_batches() {
+    std::cout << "--- Test: Unity Batches ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    createMockSources("MockBuilderApp");
+    for (const char* name : {"a", "b", "c"})
+        std::ofstream(MOCK_PROJECT_ROOT / "src" / (std::string(name) + ".cpp")) << "int f_" << name << "() { return 1; }\n";
+    std::ofstream(MOCK_PROJECT_ROOT / ".harbourConfig", std::ios::app)
+        << "unity_batch_size=\"2\"\nunity_exclude=\"src/c.cpp\"\n";
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "make";
+    options.unity = 1;
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Unity build failed.\n";
+        return false;
+    }
+    std::ifstream unity(MOCK_PROJECT_ROOT / "build" / "release" / "harbour_unity.cmake");
+    std::string content((std::istreambuf_iterator<char>(unity)), std::istreambuf_iterator<char>());
+    if (content.find("harbour_unity_1") == std::string::npos || content.find("harbour_unity_2") != std::string::npos ||
+        content.find("c.cpp\" PROPERTIES SKIP_UNITY_BUILD_INCLUSION") == std::string::npos) {
+        std::cerr << "FAIL: Sources were not batched by size or the exclusion was lost.\n";
+        return false;
+    }
+    std::cout << "PASS: Sources batched by TU budget with per-file exclusion.\n";
+    return true;
+}
+
+bool test_unity_build_runs() {
+    std::cout << "--- Test: Unity Build Compiles, Links And Runs ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    std::filesystem::create_directories(MOCK_PROJECT_ROOT / "src");
+    // Laid out like a scaffolded project, with several sources
+    std::ofstream cmake(MOCK_PROJECT_ROOT / "CMakeLists.txt");
+    cmake << "cmake_minimum_required(VERSION 3.16)\n";
+    cmake << "project(MockBuilderApp LANGUAGES CXX)\n";
+    cmake << "set(CMAKE_RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/bin)\n";
+    cmake << "add_executable(MockBuilderApp src/main.cpp src/a.cpp src/b.cpp src/c.cpp)\n";
+    cmake << "if(HARBOUR_UNITY_FILE)\n    include(${HARBOUR_UNITY_FILE})\nendif()\n";
+    cmake.close();
+    for (int i = 1; i <= 3; ++i) {
+        std::string name(1, static_cast<char>('a' + i - 1));
+        std::ofstream(MOCK_PROJECT_ROOT / "src" / (name + ".cpp"))
+            << "#include <string>\nint part_" << name << "() { return std::string(\"" << std::string(i, 'x')
+            << "\").size(); }\n";
+    }
+    std::ofstream(MOCK_PROJECT_ROOT / "src" / "main.cpp")
+        << "#include <iostream>\nint part_a();\nint part_b();\nint part_c();\n"
+           "int main() { std::cout << \"unity \" << part_a() + part_b() + part_c() << std::endl; return 0; }\n";
+    std::ofstream(MOCK_PROJECT_ROOT / ".harbourConfig", std::ios::app)
+        << "unity_batch_size=\"2\"\nunity_exclude=\"src/c.cpp\"\n";
+
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "make";
+    options.unity = 1;
+    if (!builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options)) {
+        std::cerr << "FAIL: Unity build failed.\n";
+        return false;
+    }
+    // CMake wrote the batch as one TU that includes both sources
+    bool batched = false;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(MOCK_PROJECT_ROOT / "build", ec)) {
+        if (entry.path().parent_path().filename() != "Unity") continue;
+        std::ifstream in(entry.path());
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        batched |= content.find("src/a.cpp") != std::string::npos && content.find("src/b.cpp") != std::string::npos;
+    }
+    Harbour::CommandExecutor exec;
+    auto run = exec.run({(MOCK_PROJECT_ROOT / "build" / "release" / "bin" / "MockBuilderApp").string()}, true);
+    if (!batched || run.exitCode != 0 || run.output != "unity 6\n") {
+        std::cerr << "FAIL: Expected a.cpp and b.cpp in one unity TU and \"unity 6\" from the program (" << batched
+                  << ", " << run.exitCode << ", " << run.output << ").\n";
+        return false;
+    }
+    std::cout << "PASS: Batched sources compiled together, linked and ran.\n";
+    return true;
+}
+
+bool test_manifest_without_index() {
+    std::cout << "--- Test: .hrbr Without A Package Index ---\n";
+    cleanupMockBuilderProject();
+    createMockConfig("MockBuilderApp");
+    createMockSources("MockBuilderApp");
+    std::ofstream(MOCK_PROJECT_ROOT / ".hrbr")
+        << "{\"info\": {\"name\": \"MockBuilderApp\", \"type\": \"binary\", \"version\": \"1.0.0\"},\n"
+           " \"dependencies\": {\"glfw\": \"^3.3.8\"}}\n";
+    setenv("HARBOUR_INDEX", (std::filesystem::absolute(MOCK_PROJECT_ROOT) / "no-index").c_str(), 1);
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.generator = "make";
+    bool result = builder.buildProject(MOCK_PROJECT_ROOT.string(), false, false, options);
+    unsetenv("HARBOUR_INDEX");
+    if (!result || std::filesystem::exists(MOCK_PROJECT_ROOT / "hrbr.lock")) {
+        std::cerr << "FAIL: A missing package index failed the build.\n";
+        return false;
+    }
+    std::cout << "PASS: The build went on without resolving .hrbr dependencies.\n";
+    return true;
+}
+
 int main() {
     std::cout << ">>> Running Builder Class Tests <<<\n\n";
     bool all_ok = true;
     all_ok &= test_build_failure();
+    all_ok &= test_unknown_generator();
+    all_ok &= test_configure_skipped_when_unchanged();
+    all_ok &= test_auto_pch_header();
+    all_ok &= test_unity_batches();
+    all_ok &= test_unity_build_runs();
+    all_ok &= test_manifest_without_index();
     std::cout << "\n-------------------------------------\n";
     if (all_ok) {
         std::cout << ">>> All Builder tests passed successfully! <<<\n";
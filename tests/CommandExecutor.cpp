@@ -1,5 +1,15 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <atomic>
+#include <cstdlib>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 #include "harbour.hpp"
 
 bool test_success() {
@@ -26,11 +36,422 @@ bool test_failure() {
     return true;
 }
 
+bool test_no_deadlock_on_stderr_flood() {
+    std::cout << "--- Test: No Deadlock On Stderr Flood ---\n";
+    // Fills the stderr pipe before writing stdout; a sequential reader hangs here
+    alarm(20);
+    Harbour::CommandExecutor exec;
+    auto result = exec.run({"/bin/sh", "-c", "head -c 1048576 /dev/zero >&2; echo done"}, true);
+    alarm(0);
+    if (result.exitCode != 0 || result.error.size() != 1048576 || result.output != "done\n") {
+        std::cerr << "FAIL: Both streams were not captured in full.\n";
+        return false;
+    }
+    std::cout << "PASS: 1 MiB of stderr did not block stdout.\n";
+    return true;
+}
+
+bool test_line_callback() {
+    std::cout << "--- Test: Line Callback ---\n";
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.capture = false;
+    std::vector<std::string> outLines, errLines;
+    options.onLine = [&](Harbour::CommandExecutor::Stream stream, std::string_view line) {
+        (stream == Harbour::CommandExecutor::Stream::Out ? outLines : errLines).emplace_back(line);
+    };
+    auto result = exec.run({"/bin/sh", "-c", "echo one; echo warn >&2; printf 'two\\nthree'"}, options);
+    if (result.exitCode != 0 || outLines != std::vector<std::string>{"one", "two", "three"} ||
+        errLines != std::vector<std::string>{"warn"} || !result.output.empty()) {
+        std::cerr << "FAIL: Lines were not delivered per stream, or output was captured anyway.\n";
+        return false;
+    }
+    std::cout << "PASS: Complete and trailing lines delivered per stream.\n";
+    return true;
+}
+
+bool test_capture_cap_spills() {
+    std::cout << "--- Test: Capture Cap Spills To Disk ---\n";
+    std::string spill = (std::filesystem::temp_directory_path() / "harbour_exec_test").string();
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.maxCaptureBytes = 1000;
+    options.spillPath = spill;
+    auto result = exec.run({"/bin/sh", "-c", "seq 1 20000"}, options);
+    std::error_code ec;
+    auto spilled = std::filesystem::file_size(spill + ".stdout", ec);
+    bool ok = result.truncated && result.outputSpill == spill + ".stdout" && result.output.size() == 1000 &&
+              result.output.substr(result.output.size() - 6) == "20000\n" && spilled == 108894 &&
+              result.errorSpill.empty();
+    std::filesystem::remove(spill + ".stdout", ec);
+    if (!ok) {
+        std::cerr << "FAIL: Expected a 1000 byte tail in memory and the full log on disk.\n";
+        return false;
+    }
+    std::cout << "PASS: Memory held the tail, the full log spilled to disk.\n";
+    return true;
+}
+
+bool test_merge_stderr() {
+    std::cout << "--- Test: Merge Stderr ---\n";
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.mergeStderr = true;
+    auto result = exec.run({"/bin/sh", "-c", "echo a; echo b >&2; echo c"}, options);
+    if (result.output != "a\nb\nc\n" || !result.error.empty()) {
+        std::cerr << "FAIL: Streams were not merged in order.\n";
+        return false;
+    }
+    std::cout << "PASS: stderr interleaved into the captured output.\n";
+    return true;
+}
+
+bool test_tee_log_keeps_tail() {
+    std::cout << "--- Test: Tee Log Keeps Tail ---\n";
+    std::string log = (std::filesystem::temp_directory_path() / "harbour_exec_tee.log").string();
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.capture = false;
+    options.teePath = log;
+    options.tailBytes = 100;
+    auto result = exec.run({"/bin/sh", "-c", "seq 1 2000; echo boom >&2; exit 3"}, options);
+    std::error_code ec;
+    auto logged = std::filesystem::file_size(log, ec);
+    std::filesystem::remove(log, ec);
+    // seq 1 2000 prints 8893 bytes, plus "boom\n"
+    bool ok = result.exitCode == 3 && logged == 8898 && result.output.size() == 100 &&
+              result.output.substr(result.output.size() - 5) == "2000\n" && result.error == "boom\n" &&
+              result.truncated;
+    if (!ok) {
+        std::cerr << "FAIL: Expected the full log on disk and a 100 byte tail per stream.\n";
+        return false;
+    }
+    std::cout << "PASS: Output forwarded, logged in full and tailed.\n";
+    return true;
+}
+
+bool test_on_spawn_runs_before_exec() {
+    std::cout << "--- Test: onSpawn Runs Before Exec ---\n";
+    std::string marker = (std::filesystem::temp_directory_path() / "harbour_exec_spawn").string();
+    std::error_code ec;
+    std::filesystem::remove(marker, ec);
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    pid_t seen = 0;
+    options.onSpawn = [&](pid_t pid) {
+        seen = pid;
+        std::ofstream(marker) << "ready";
+    };
+    auto result = exec.run({"/bin/sh", "-c", "cat " + marker + "; echo \" $$\""}, options);
+    std::filesystem::remove(marker, ec);
+    if (result.output != "ready " + std::to_string(seen) + "\n") {
+        std::cerr << "FAIL: The child ran before onSpawn returned: " << result.output << "\n";
+        return false;
+    }
+    std::cout << "PASS: The child waited for onSpawn.\n";
+    return true;
+}
+
+bool test_spawn_cwd_env_and_fds() {
+    std::cout << "--- Test: Spawn With Cwd, Env And Closed Descriptors ---\n";
+    // Opened without O_CLOEXEC, as a careless library might
+    int leaked = open("/dev/null", O_RDONLY);
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.cwd = "/";
+    options.env = {"HARBOUR_SPAWN_TEST=yes", "HOME=/nowhere"};
+    auto result = exec.run({"sh", "-c", "pwd; echo $HARBOUR_SPAWN_TEST $HOME; test -e /proc/self/fd/" +
+                                            std::to_string(leaked) + " && echo leaked || echo closed"},
+                           options);
+    close(leaked);
+    if (result.output != "/\nyes /nowhere\nclosed\n") {
+        std::cerr << "FAIL: Unexpected child state:\n" << result.output;
+        return false;
+    }
+    auto missing = exec.run({"harbour-no-such-program"}, true);
+    if (missing.exitCode != 127 || missing.error.find("harbour-no-such-program") == std::string::npos) {
+        std::cerr << "FAIL: A missing program was not reported.\n";
+        return false;
+    }
+    std::cout << "PASS: cwd and env applied, inherited descriptors closed.\n";
+    return true;
+}
+
+bool test_env_entry_without_name() {
+    std::cout << "--- Test: Env Override Keeps Entries Without '=' ---\n";
+    // execve accepts such entries, so a parent may well have handed us one
+    std::string path = std::string("PATH=") + (getenv("PATH") ? getenv("PATH") : "/usr/bin:/bin");
+    std::vector<char*> custom = {const_cast<char*>("HARBOUR_NAMELESS"), const_cast<char*>("HARBOUR_KEPT=1"),
+                                 path.data(), nullptr};
+    char** saved = environ;
+    environ = custom.data();
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.env = {"HARBOUR_KEPT=2"};
+    auto result = exec.run({"env"}, options);
+    environ = saved;
+    bool nameless = result.output.find("HARBOUR_NAMELESS\n") != std::string::npos;
+    bool overridden = result.output.find("HARBOUR_KEPT=2\n") != std::string::npos &&
+                      result.output.find("HARBOUR_KEPT=1") == std::string::npos;
+    if (result.exitCode != 0 || !nameless || !overridden) {
+        std::cerr << "FAIL: Unexpected child environment:\n" << result.output;
+        return false;
+    }
+    std::cout << "PASS: The nameless entry survived and the override replaced its variable.\n";
+    return true;
+}
+
+bool test_pool_bounded_concurrency() {
+    std::cout << "--- Test: Pool Runs A Bounded Number At Once ---\n";
+    Harbour::ProcessPool pool(2);
+    std::atomic<int> finished{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 6; ++i)
+        pool.submit({"sleep", "0.2"}, {}, [&](Harbour::CommandExecutor::Result result) {
+            if (result.exitCode == 0) ++finished;
+        });
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Three rounds of two
+    if (finished != 6 || seconds < 0.55 || seconds > 1.5) {
+        std::cerr << "FAIL: " << finished << " finished in " << seconds << "s.\n";
+        return false;
+    }
+    std::cout << "PASS: Six sleeps took " << seconds << "s with two at a time.\n";
+    return true;
+}
+
+bool test_pool_futures_and_usage() {
+    std::cout << "--- Test: Pool Futures Carry Output And Usage ---\n";
+    Harbour::ProcessPool pool(4);
+    std::vector<std::future<Harbour::CommandExecutor::Result>> results;
+    for (int i = 0; i < 8; ++i)
+        results.push_back(pool.submit({"sh", "-c", "echo out" + std::to_string(i) + "; echo err >&2; exit " +
+                                                       std::to_string(i % 2)}));
+    auto missing = pool.submit({"harbour-no-such-program"});
+    for (int i = 0; i < 8; ++i) {
+        auto result = results[i].get();
+        if (result.output != "out" + std::to_string(i) + "\n" || result.error != "err\n" ||
+            result.exitCode != i % 2 || result.usage.ru_maxrss <= 0) {
+            std::cerr << "FAIL: Command " << i << " came back wrong.\n";
+            return false;
+        }
+    }
+    if (missing.get().exitCode != 127) {
+        std::cerr << "FAIL: A missing program did not complete with 127.\n";
+        return false;
+    }
+    std::cout << "PASS: Every future held its own output, exit code and rusage.\n";
+    return true;
+}
+
+bool test_pool_cancel_all() {
+    std::cout << "--- Test: Pool Cancels Process Groups ---\n";
+    auto start = std::chrono::steady_clock::now();
+    Harbour::ProcessPool pool(1);
+    // The background sleep keeps the pipe open; only a group kill ends it
+    auto running = pool.submit({"sh", "-c", "sleep 30 & wait"});
+    auto queued = pool.submit({"sleep", "30"});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    pool.cancelAll();
+    auto first = running.get();
+    auto second = queued.get();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!first.cancelled || !second.cancelled || seconds > 3) {
+        std::cerr << "FAIL: Cancel took " << seconds << "s.\n";
+        return false;
+    }
+    std::cout << "PASS: Running group killed and queued command dropped.\n";
+    return true;
+}
+
+bool test_timeout_escalates() {
+    std::cout << "--- Test: Timeouts Escalate To SIGKILL ---\n";
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.timeoutMs = 200;
+    options.killGraceMs = 200;
+    // Ignores SIGTERM, so only the SIGKILL stops it
+    auto result = exec.run({"sh", "-c", "trap '' TERM; sleep 10 & wait; sleep 10"}, options);
+    if (!result.timedOut || result.cancelled || result.wallMs < 350 || result.wallMs > 5000) {
+        std::cerr << "FAIL: Timed out " << result.timedOut << " after " << result.wallMs << " ms.\n";
+        return false;
+    }
+    auto quick = exec.run({"true"}, options);
+    if (quick.timedOut || quick.exitCode != 0) {
+        std::cerr << "FAIL: A command inside its timeout was stopped.\n";
+        return false;
+    }
+    std::cout << "PASS: The command was killed after its timeout and grace period.\n";
+    return true;
+}
+
+bool test_foreground_keeps_terminal() {
+    std::cout << "--- Test: Foreground Commands Keep The Terminal ---\n";
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::cout << "PASS: Skipped, no pseudo-terminals here.\n";
+        return true;
+    }
+    std::string slave = ptsname(master);
+    pid_t pid = fork();
+    if (pid == 0) {
+        // A session of our own with the pty as its controlling terminal,
+        // like an interactive shell running `harbour run`
+        setsid();
+        int tty = open(slave.c_str(), O_RDWR);
+        if (tty < 0) _exit(2);
+        dup2(tty, STDIN_FILENO);
+        Harbour::CommandExecutor exec;
+        Harbour::CommandExecutor::Options options;
+        options.timeoutMs = 5000;
+        options.foreground = true;
+        // Stopped by SIGTTIN, and timed out, if it were not in the foreground group
+        auto result = exec.run({"head", "-c", "1"}, options);
+        _exit(result.output == "x" && !result.timedOut ? 0 : 1);
+    }
+    if (write(master, "x\n", 2) != 2) std::cerr << "write to the pty failed\n";
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(master);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "FAIL: The command could not read the terminal under a timeout.\n";
+        return false;
+    }
+    std::cout << "PASS: A foreground command read the terminal under a timeout.\n";
+    return true;
+}
+
+bool test_result_cost() {
+    std::cout << "--- Test: Results Carry Their Cost ---\n";
+    Harbour::CommandExecutor exec;
+    auto result = exec.run({"sh", "-c", "head -c 1000000 /dev/zero | wc -c"}, true);
+    if (result.output != "1000000\n" || result.wallMs <= 0 || result.cpuMs < 0 || result.maxRssKb <= 0) {
+        std::cerr << "FAIL: wall " << result.wallMs << " ms, cpu " << result.cpuMs << " ms, rss "
+                  << result.maxRssKb << " KiB.\n";
+        return false;
+    }
+    // Both ends of the pipe are children the shell reaped
+    if (std::filesystem::exists("/proc/self/io") && result.readBytes < 2000000) {
+        std::cerr << "FAIL: Only " << result.readBytes << " bytes read were counted.\n";
+        return false;
+    }
+    std::cout << "PASS: Wall time, CPU time, max RSS and I/O were recorded.\n";
+    return true;
+}
+
+bool test_limits() {
+    std::cout << "--- Test: Resource Limits ---\n";
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.limits.openFiles = 64;
+    options.limits.fileSize = 4096;
+    auto result = exec.run({"sh", "-c", "ulimit -n; ulimit -f"}, options);
+    if (result.output != "64\n8\n") {
+        std::cerr << "FAIL: The child saw limits " << result.output << "\n";
+        return false;
+    }
+    std::cout << "PASS: rlimits reached the child.\n";
+
+    // Where the caps cannot be set they are skipped, never fatal, and
+    // Harbour itself stays in the cgroup it started in
+    auto ownGroup = [] {
+        std::ifstream in("/proc/self/cgroup");
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    std::string before = ownGroup();
+    options = {};
+    options.limits.memoryMax = 16ull << 20;
+    options.limits.cpuMax = 0.5;
+    auto placed = exec.run({"cat", "/proc/self/cgroup"}, options);
+    if (placed.exitCode != 0 || ownGroup() != before) {
+        std::cerr << "FAIL: A capped command did not run, or moved us out of our cgroup.\n";
+        return false;
+    }
+    const char* delegated = std::getenv("HARBOUR_CGROUP");
+    if (placed.output.find("/harbour-" + std::to_string(getpid()) + "-") == std::string::npos) {
+        std::cout << "PASS: Skipped cgroup enforcement"
+                  << (delegated ? ", HARBOUR_CGROUP is not usable here.\n" : ", no HARBOUR_CGROUP set.\n");
+        return true;
+    }
+    // 64 MiB held by the shell against a 16 MiB memory.max
+    auto hog = exec.run({"sh", "-c", "x=$(head -c 67108864 /dev/zero | tr '\\0' a); echo ${#x}"}, options);
+    bool leftovers = false;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(delegated, ec))
+        leftovers |= entry.path().filename().string().rfind("harbour-" + std::to_string(getpid()) + "-", 0) == 0;
+    if (hog.exitCode == 0 || leftovers) {
+        std::cerr << "FAIL: A command got past memory.max, or its group was left behind.\n";
+        return false;
+    }
+    std::cout << "PASS: memory.max stopped a command that allocated past it.\n";
+    return true;
+}
+
+bool test_pool_timeout() {
+    std::cout << "--- Test: Pool Timeouts ---\n";
+    Harbour::ProcessPool pool(2);
+    Harbour::CommandExecutor::Options options;
+    options.timeoutMs = 200;
+    auto slow = pool.submit({"sleep", "10"}, options);
+    auto fast = pool.submit({"true"}, options);
+    auto result = slow.get();
+    if (!result.timedOut || result.cancelled || result.wallMs > 5000 || fast.get().timedOut) {
+        std::cerr << "FAIL: The pool did not time out only the slow command.\n";
+        return false;
+    }
+    std::cout << "PASS: The pool stopped the command that ran past its timeout.\n";
+    return true;
+}
+
+bool test_pool_stops_background_grandchild() {
+    std::cout << "--- Test: Pool Stops What An Exited Command Left Behind ---\n";
+    // sh exits at once, but the backgrounded sleep keeps stdout open
+    const std::vector<std::string> args = {"sh", "-c", "sleep 6 & echo hi"};
+    Harbour::ProcessPool pool(2);
+    Harbour::CommandExecutor::Options options;
+    options.timeoutMs = 300;
+    auto start = std::chrono::steady_clock::now();
+    auto timed = pool.submit(args, options).get();
+    double timedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    auto cancelled = pool.submit(args);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    pool.cancelAll();
+    auto result = cancelled.get();
+    double cancelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!timed.timedOut || timedSeconds > 3 || !result.cancelled || cancelSeconds > 3) {
+        std::cerr << "FAIL: Timeout took " << timedSeconds << "s (timed out " << timed.timedOut << "), cancel took "
+                  << cancelSeconds << "s (cancelled " << result.cancelled << ").\n";
+        return false;
+    }
+    std::cout << "PASS: The grandchild was stopped by the timeout and by cancelAll().\n";
+    return true;
+}
+
 int main() {
     std::cout << ">>> Running CommandExecutor Tests <<<\n\n";
     bool all_ok = true;
     all_ok &= test_success();
     all_ok &= test_failure();
+    all_ok &= test_no_deadlock_on_stderr_flood();
+    all_ok &= test_line_callback();
+    all_ok &= test_capture_cap_spills();
+    all_ok &= test_merge_stderr();
+    all_ok &= test_tee_log_keeps_tail();
+    all_ok &= test_on_spawn_runs_before_exec();
+    all_ok &= test_spawn_cwd_env_and_fds();
+    all_ok &= test_env_entry_without_name();
+    all_ok &= test_pool_bounded_concurrency();
+    all_ok &= test_pool_futures_and_usage();
+    all_ok &= test_pool_cancel_all();
+    all_ok &= test_timeout_escalates();
+    all_ok &= test_foreground_keeps_terminal();
+    all_ok &= test_result_cost();
+    all_ok &= test_limits();
+    all_ok &= test_pool_timeout();
+    all_ok &= test_pool_stops_background_grandchild();
     std::cout << "\n-------------------------------------\n";
     if (all_ok) {
         std::cout << ">>> All CommandExecutor tests passed successfully! <<<\n";
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_CACHE_ROOT = "mock_compile_cache";
+
+void cleanupMockCache() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_CACHE_ROOT, ec);
+}
+
+// Creates <checkout>/src/unit.cpp and returns the absolute checkout path
+std::string createCheckout(const std::string& name) {
+    auto root = MOCK_CACHE_ROOT / name;
+    std::filesystem::create_directories(root / "src");
+    std::ofstream src(root / "src" / "unit.cpp");
+    src << "int answer() { return 42; }\n";
+    src.close();
+    return std::filesystem::absolute(root).string();
+}
+
+int compileIn(Harbour::Project::CompileCache& cache, const std::string& root) {
+    return cache.exec(root, {"c++", "-c", root + "/src/unit.cpp", "-o", root + "/unit.o",
+                             "-MD", "-MT", "unit.o", "-MF", root + "/unit.o.d"});
+}
+
+bool test_hit_after_miss() {
+    std::cout << "--- Test: Hit After Miss ---\n";
+    cleanupMockCache();
+    Harbour::Project::CompileCache cache((MOCK_CACHE_ROOT / "store").string());
+    std::string root = createCheckout("first");
+    if (compileIn(cache, root) != 0 || compileIn(cache, root) != 0) {
+        std::cerr << "FAIL: Compiling through the cache failed.\n";
+        return false;
+    }
+    auto stats = cache.stats();
+    if (stats.misses != 1 || stats.hits != 1 || !std::filesystem::exists(root + "/unit.o")) {
+        std::cerr << "FAIL: Expected one miss then one hit, got " << stats.misses << "/" << stats.hits << ".\n";
+        return false;
+    }
+    std::cout << "PASS: Second compile was served from the cache.\n";
+    return true;
+}
+
+bool test_hit_across_checkouts() {
+    std::cout << "--- Test: Hit Across Checkouts ---\n";
+    cleanupMockCache();
+    Harbour::Project::CompileCache cache((MOCK_CACHE_ROOT / "store").string());
+    std::string first = createCheckout("first");
+    std::string second = createCheckout("second");
+    if (compileIn(cache, first) != 0 || compileIn(cache, second) != 0) {
+        std::cerr << "FAIL: Compiling through the cache failed.\n";
+        return false;
+    }
+    std::ifstream dep(second + "/unit.o.d");
+    std::string deps((std::istreambuf_iterator<char>(dep)), std::istreambuf_iterator<char>());
+    if (cache.stats().hits != 1 || deps.find(second + "/src/unit.cpp") == std::string::npos) {
+        std::cerr << "FAIL: Second checkout missed or got a depfile with foreign paths.\n";
+        return false;
+    }
+    std::cout << "PASS: Base-dir remapping shares entries between checkouts.\n";
+    return true;
+}
+
+bool test_eviction() {
+    std::cout << "--- Test: LRU Eviction ---\n";
+    cleanupMockCache();
+    Harbour::Project::CompileCache cache((MOCK_CACHE_ROOT / "store").string());
+    cache.maxSize = 1;
+    std::string root = createCheckout("first");
+    if (compileIn(cache, root) != 0) {
+        std::cerr << "FAIL: Compiling through the cache failed.\n";
+        return false;
+    }
+    auto stats = cache.stats();
+    if (stats.entries != 0 || stats.sizeBytes != 0) {
+        std::cerr << "FAIL: Entries were kept beyond the size limit.\n";
+        return false;
+    }
+    std::cout << "PASS: Entries over the size limit were evicted.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running CompileCache Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_hit_after_miss();
+    all_ok &= test_hit_across_checkouts();
+    all_ok &= test_eviction();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All CompileCache tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME COMPILECACHE TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockCache();
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_PROFILE_ROOT = "mock_compile_profile";
+
+void cleanupMockProfile() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_PROFILE_ROOT, ec);
+}
+
+bool test_exec_records_gcc_report() {
+    std::cout << "--- Test: Exec Records Time Report ---\n";
+    cleanupMockProfile();
+    std::filesystem::create_directories(MOCK_PROFILE_ROOT);
+    std::string root = std::filesystem::absolute(MOCK_PROFILE_ROOT).string();
+    std::ofstream src(root + "/unit.cpp");
+    src << "#include <vector>\nint answer() { return std::vector<int>(42).size(); }\n";
+    src.close();
+
+    Harbour::Project::CompileProfiler profiler;
+    int rc = profiler.exec("-ftime-report", {"g++", "-c", root + "/unit.cpp", "-o", root + "/unit.o"});
+    if (rc != 0 || !std::filesystem::exists(root + "/unit.o.harbour-profile")) {
+        std::cerr << "FAIL: Compile failed or no profile record was written.\n";
+        return false;
+    }
+    if (!profiler.collect(root) || profiler.getUnits().size() != 1 || profiler.phases().empty()) {
+        std::cerr << "FAIL: Record did not yield a unit with -ftime-report phases.\n";
+        return false;
+    }
+    std::cout << "PASS: Unit wall time and GCC phases recorded.\n";
+    return true;
+}
+
+bool test_clang_trace_and_budget() {
+    std::cout << "--- Test: Clang Trace Aggregation And Budget ---\n";
+    cleanupMockProfile();
+    std::filesystem::create_directories(MOCK_PROFILE_ROOT / "a");
+    std::string root = std::filesystem::absolute(MOCK_PROFILE_ROOT).string();
+    const char *trace = R"({"traceEvents": [
+        {"ph": "X", "name": "Source", "dur": 4000, "args": {"detail": "/usr/include/c++/vector"}},
+        {"ph": "X", "name": "InstantiateClass", "dur": 2500, "args": {"detail": "std::vector<int>"}},
+        {"ph": "M", "name": "process_name", "args": {"name": "clang"}}]})";
+    for (const char *unit : {"fast", "slow"}) {
+        std::string object = root + "/a/" + unit + ".cpp.o";
+        std::ofstream(root + "/a/" + unit + ".cpp.json") << trace;
+        std::ofstream(object + ".harbour-profile") << "source=/src/" << unit << ".cpp\nobject=" << object
+                                                   << "\nwall_ms=" << (unit[0] == 's' ? 900 : 100)
+                                                   << "\ntrace=" << root << "/a/" << unit << ".cpp.json\n";
+    }
+    Harbour::Project::CompileProfiler profiler;
+    profiler.collect(root);
+    auto headers = profiler.headers();
+    auto templates = profiler.templates();
+    if (headers.size() != 1 || headers[0].ms != 8.0 || headers[0].count != 2 || templates.size() != 1 ||
+        templates[0].name != "std::vector<int>") {
+        std::cerr << "FAIL: Trace events were not aggregated across units.\n";
+        return false;
+    }
+    auto over = profiler.overBudget(500);
+    if (over.size() != 1 || over[0].source != "/src/slow.cpp" || !profiler.overBudget(0).empty()) {
+        std::cerr << "FAIL: Budget check did not single out the slow unit.\n";
+        return false;
+    }
+    Harbour::Project::CompileProfiler::reset(root);
+    if (profiler.collect(root)) {
+        std::cerr << "FAIL: reset() left profile records behind.\n";
+        return false;
+    }
+    std::cout << "PASS: Headers and templates aggregated, budget enforced.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running CompileProfiler Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_exec_records_gcc_report();
+    all_ok &= test_clang_trace_and_budget();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All CompileProfiler tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME COMPILEPROFILER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockProfile();
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_DAEMON_ROOT = "mock_daemon_project";
+
+void cleanupMockDaemon() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_DAEMON_ROOT, ec);
+}
+
+void createMockProject() {
+    cleanupMockDaemon();
+    std::filesystem::create_directories(MOCK_DAEMON_ROOT / "src");
+    std::ofstream config(MOCK_DAEMON_ROOT / ".harbourConfig");
+    config << "project_name=\"DaemonApp\"\nruntime_bin=\"bin\"\nruntime_lib=\"lib\"\nenable_graphics=\"false\"\n";
+    config.close();
+    std::ofstream cmake(MOCK_DAEMON_ROOT / "CMakeLists.txt");
+    cmake << "cmake_minimum_required(VERSION 3.16)\nproject(DaemonApp LANGUAGES CXX)\n";
+    cmake << "set(CMAKE_RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/bin)\n";
+    cmake << "add_executable(DaemonApp src/main.cpp)\n";
+    cmake.close();
+    std::ofstream main(MOCK_DAEMON_ROOT / "src" / "main.cpp");
+    main << "int main() { return 0; }\n";
+}
+
+// Forwards a command with stdout redirected to a file and returns what the
+// daemon wrote there
+std::string forwardCaptured(const std::vector<std::string>& args, int& code, bool& forwarded) {
+    std::string capture = (MOCK_DAEMON_ROOT / "stdout.txt").string();
+    std::cout.flush();
+    int saved = dup(STDOUT_FILENO);
+    int fd = open(capture.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+    forwarded = Harbour::Project::Daemon::forward(args, code);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    std::ifstream in(capture);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+bool test_fallback_without_daemon() {
+    std::cout << "--- Test: Fallback Without Daemon ---\n";
+    int code = 0;
+    if (Harbour::Project::Daemon::forward({"daemon", "status"}, code)) {
+        std::cerr << "FAIL: forward() claimed a daemon that is not running.\n";
+        return false;
+    }
+    std::cout << "PASS: forward() reports no daemon so the CLI runs in-process.\n";
+    return true;
+}
+
+bool test_noop_build_answered_by_daemon() {
+    std::cout << "--- Test: No-op Build Answered By Daemon ---\n";
+    createMockProject();
+    pid_t daemon = fork();
+    if (daemon == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        Harbour::Project::Daemon d;
+        _exit(d.serve());
+    }
+    int code = 1;
+    bool forwarded = false;
+    for (int i = 0; i < 100 && !forwarded; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        forwardCaptured({"daemon", "status"}, code, forwarded);
+    }
+    std::string project = MOCK_DAEMON_ROOT.string();
+    std::string first = forwardCaptured({"build", "--generator", "make", project}, code, forwarded);
+    bool builtFirst = forwarded && code == 0 && first.find("Building project") != std::string::npos;
+    auto start = std::chrono::steady_clock::now();
+    std::string second = forwardCaptured({"build", "--generator", "make", project}, code, forwarded);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    bool fastSecond = code == 0 && second.find("Up to date (harbourd)") != std::string::npos;
+    std::ofstream(MOCK_DAEMON_ROOT / "src" / "main.cpp") << "int main() { return 1 - 1; }\n";
+    std::string third = forwardCaptured({"build", "--generator", "make", project}, code, forwarded);
+    bool rebuiltThird = code == 0 && third.find("Building CXX object") != std::string::npos;
+
+    forwardCaptured({"daemon", "stop"}, code, forwarded);
+    int status = 0;
+    waitpid(daemon, &status, 0);
+    if (!builtFirst || !fastSecond || !rebuiltThird) {
+        std::cerr << "FAIL: Expected build, then daemon no-op, then rebuild after an edit ("
+                  << builtFirst << fastSecond << rebuiltThird << ").\n";
+        return false;
+    }
+    std::cout << "PASS: No-op build answered in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+              << " ms, edits still rebuild.\n";
+    return true;
+}
+
+bool test_status_answered_during_build() {
+    std::cout << "--- Test: Status Answered During a Build ---\n";
+    createMockProject();
+    // A build step that keeps the worker busy for a while
+    std::ofstream(MOCK_DAEMON_ROOT / "CMakeLists.txt", std::ios::app)
+        << "add_custom_target(slow ALL COMMAND ${CMAKE_COMMAND} -E sleep 3)\n";
+    pid_t daemon = fork();
+    if (daemon == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        Harbour::Project::Daemon d;
+        _exit(d.serve());
+    }
+    int code = 1;
+    bool forwarded = false;
+    for (int i = 0; i < 100 && !forwarded; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        forwardCaptured({"daemon", "status"}, code, forwarded);
+    }
+    struct stat info {};
+    bool privateSocket = stat(getenv("HARBOUR_DAEMON_SOCKET"), &info) == 0 && (info.st_mode & 077) == 0;
+
+    std::string project = MOCK_DAEMON_ROOT.string();
+    pid_t client = fork();
+    if (client == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        int buildCode = 1;
+        bool sent = Harbour::Project::Daemon::forward({"build", "--generator", "make", project}, buildCode);
+        _exit(sent ? buildCode : 99);
+    }
+    bool sawBuild = false, busyRefused = false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (!sawBuild && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::string status = forwardCaptured({"daemon", "status"}, code, forwarded);
+        sawBuild = forwarded && status.find("running: harbour build") != std::string::npos;
+    }
+    if (sawBuild) busyRefused = !Harbour::Project::Daemon::forward({"build", project}, code);
+    int status = 0;
+    waitpid(client, &status, 0);
+    bool built = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    forwardCaptured({"daemon", "stop"}, code, forwarded);
+    waitpid(daemon, &status, 0);
+    if (!privateSocket || !sawBuild || !busyRefused || !built) {
+        std::cerr << "FAIL: Expected a private socket, status during the build, a busy refusal and a clean build ("
+                  << privateSocket << sawBuild << busyRefused << built << ").\n";
+        return false;
+    }
+    std::cout << "PASS: Status answered and a second build sent back while the first ran.\n";
+    return true;
+}
+
+int main() {
+    std::string socket = std::filesystem::absolute("mock_daemon.sock").string();
+    setenv("HARBOUR_DAEMON_SOCKET", socket.c_str(), 1);
+    unsetenv("HARBOUR_NO_DAEMON");
+    std::cout << ">>> Running Daemon Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_fallback_without_daemon();
+    all_ok &= test_noop_build_answered_by_daemon();
+    all_ok &= test_status_answered_during_build();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Daemon tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME DAEMON TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockDaemon();
+    return all_ok ? 0 : 1;
+}
@@ -1,8 +1,11 @@
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <string>
 #include "harbour.hpp"
+#include "sysinfo.hpp"
 
 
 const std::filesystem::path MOCK_DEP_ROOT = "mock_dep_project";
@@ -32,10 +35,215 @@ bool test_no_graphics() {
     return true;
 }
 
+// Local upstream repos tagged at the pinned revisions, served through
+// HARBOUR_MIRROR_<DEP>. The glad repo carries a stand-in `glad` module so
+// that `python3 -m glad` works offline.
+void createUpstreams() {
+    auto upstream = std::filesystem::absolute(MOCK_DEP_ROOT / "upstream");
+    const std::pair<const char *, const char *> repos[] = {{"GLFW", "3.4"}, {"GLM", "1.0.1"}, {"GLAD", "v2.0.8"}};
+    for (const auto &[name, tag] : repos) {
+        auto repo = upstream / name;
+        std::filesystem::create_directories(repo);
+        std::ofstream(repo / "CMakeLists.txt") << "# " << name << "\n";
+        if (std::string(name) == "GLAD") {
+            std::filesystem::create_directories(repo / "glad");
+            std::ofstream(repo / "glad" / "__init__.py") << "";
+            std::ofstream(repo / "glad" / "__main__.py")
+                << "import os, sys\nos.makedirs('GL/src', exist_ok=True)\n"
+                   "open('GL/src/gl.c', 'w').write(' '.join(sys.argv[1:]))\n"
+                   "if os.environ.get('GLAD_RUNS'):\n    open(os.environ['GLAD_RUNS'], 'a').write('run\\n')\n";
+        }
+        std::string cmd = "cd '" + repo.string() + "' && git init -q && git add -A && "
+                          "git -c user.name=t -c user.email=t@t commit -qm init && git tag " + tag;
+        std::system(cmd.c_str());
+        setenv(("HARBOUR_MIRROR_" + std::string(name)).c_str(), ("file://" + repo.string()).c_str(), 1);
+    }
+    setenv("HARBOUR_STORE", std::filesystem::absolute(MOCK_DEP_ROOT / "store").c_str(), 1);
+}
+
+// Puts a `git` wrapper first on PATH that delays every fetch by `delay`
+// seconds, or fails fetches whose arguments mention `failOn`.
+std::string installGitWrapper(const std::string& delay, const std::string& failOn) {
+    auto bin = std::filesystem::absolute(MOCK_DEP_ROOT / "fakebin");
+    std::filesystem::create_directories(bin);
+    std::string realGit = Harbour::Sys::findProgram("git");
+    std::ofstream git(bin / "git");
+    git << "#!/bin/sh\ncase \" $* \" in *\" fetch \"*)\n";
+    if (!failOn.empty()) git << "  case \"$*\" in *" << failOn << "*) echo 'fatal: unreachable' >&2; exit 128;; esac\n";
+    git << "  sleep " << delay << ";;\nesac\nexec '" << realGit << "' \"$@\"\n";
+    git.close();
+    std::filesystem::permissions(bin / "git", std::filesystem::perms::owner_all);
+    std::string oldPath = std::getenv("PATH");
+    setenv("PATH", (bin.string() + ":" + oldPath).c_str(), 1);
+    return oldPath;
+}
+
+bool test_parallel_fetch() {
+    std::cout << "--- Test: Parallel Fetch ---\n";
+    cleanupMockDepProject();
+    createUpstreams();
+    std::string oldPath = installGitWrapper("0.6", "");
+    createMockDepDir();
+    Harbour::Project::DependencyManager dep;
+    auto start = std::chrono::steady_clock::now();
+    bool result = dep.checkDependencies(true);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    bool fetched = std::filesystem::exists("external/glfw/CMakeLists.txt") &&
+                   std::filesystem::exists("external/glm/CMakeLists.txt") &&
+                   std::filesystem::exists("external/glad/GL/src/gl.c");
+    std::filesystem::current_path("../");
+    setenv("PATH", oldPath.c_str(), 1);
+    if (!result || !fetched) {
+        std::cerr << "FAIL: Dependencies were not all fetched.\n";
+        return false;
+    }
+    if (elapsed > std::chrono::milliseconds(1500)) {
+        std::cerr << "FAIL: Three 0.6s fetches took longer than running them side by side should.\n";
+        return false;
+    }
+    std::cout << "PASS: Fetches ran concurrently and GLAD was generated.\n";
+    return true;
+}
+
+bool test_failure_cancels_others() {
+    std::cout << "--- Test: Failure Cancels Others ---\n";
+    cleanupMockDepProject();
+    createUpstreams();
+    std::string oldPath = installGitWrapper("10", "GLM");
+    createMockDepDir();
+    Harbour::Project::DependencyManager dep;
+    auto start = std::chrono::steady_clock::now();
+    bool result = dep.checkDependencies(true);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    bool leftovers = std::filesystem::exists("external/glfw") || std::filesystem::exists("external/glad");
+    std::filesystem::current_path("../");
+    setenv("PATH", oldPath.c_str(), 1);
+    if (result || leftovers || elapsed > std::chrono::seconds(5)) {
+        std::cerr << "FAIL: A failed fetch did not promptly cancel and clean up the others.\n";
+        return false;
+    }
+    std::cout << "PASS: Failure cancelled the in-flight fetches without leftovers.\n";
+    return true;
+}
+
+bool test_store_shared_offline() {
+    std::cout << "--- Test: Store Shared Offline ---\n";
+    cleanupMockDepProject();
+    createUpstreams();
+    createMockDepDir();
+    Harbour::Project::DependencyManager first;
+    bool fetched = first.checkDependencies(true);
+    std::filesystem::current_path("../");
+    // Upstreams gone: a second project must be served from the store alone
+    std::filesystem::remove_all(MOCK_DEP_ROOT / "upstream");
+    std::filesystem::create_directories(MOCK_DEP_ROOT / "second");
+    std::filesystem::current_path(MOCK_DEP_ROOT / "second");
+    Harbour::Project::DependencyManager second;
+    bool reused = second.checkDependencies(true);
+    std::error_code ec;
+    auto perms = std::filesystem::status("external/glfw/CMakeLists.txt", ec).permissions();
+    bool shared = reused && std::filesystem::exists("external/glm/CMakeLists.txt") &&
+                  (perms & std::filesystem::perms::owner_write) == std::filesystem::perms::none;
+    std::filesystem::current_path("../../");
+    auto trees = std::distance(std::filesystem::directory_iterator(MOCK_DEP_ROOT / "store" / "trees"),
+                               std::filesystem::directory_iterator());
+    if (!fetched || !shared || trees != 3) {
+        std::cerr << "FAIL: Second project was not checked out from the shared store.\n";
+        return false;
+    }
+    std::cout << "PASS: One tree per dependency, reused without the upstream repos.\n";
+    return true;
+}
+
+// Number of times the stand-in glad generator ran
+int gladRuns() {
+    std::ifstream runs(std::filesystem::absolute(MOCK_DEP_ROOT / "glad_runs"));
+    int count = 0;
+    std::string line;
+    while (std::getline(runs, line)) ++count;
+    return count;
+}
+
+std::string loaderIn(const std::string& project) {
+    std::ifstream loader(MOCK_DEP_ROOT / project / "external/glad/GL/src/gl.c");
+    std::string contents;
+    std::getline(loader, contents);
+    return contents;
+}
+
+bool checkIn(const std::string& project, const std::string& gladApi) {
+    std::filesystem::create_directories(MOCK_DEP_ROOT / project);
+    std::filesystem::current_path(MOCK_DEP_ROOT / project);
+    Harbour::Project::ConfigManager cfg;
+    cfg.gladApi = gladApi;
+    Harbour::Project::DependencyManager dep(cfg);
+    bool result = dep.checkDependencies(true);
+    std::filesystem::current_path("../../");
+    return result;
+}
+
+bool test_loader_cached() {
+    std::cout << "--- Test: Loader Cached ---\n";
+    cleanupMockDepProject();
+    createUpstreams();
+    setenv("GLAD_RUNS", std::filesystem::absolute(MOCK_DEP_ROOT / "glad_runs").c_str(), 1);
+    bool ok = checkIn("a", "") && checkIn("b", "") && gladRuns() == 1 &&
+              loaderIn("b").find("gl:compatibility=3.3") != std::string::npos;
+    // A new spec is generated once; switching back comes from the cache
+    ok &= checkIn("c", "gl:core=4.6") && gladRuns() == 2 && loaderIn("c").find("gl:core=4.6") != std::string::npos;
+    ok &= checkIn("c", "") && gladRuns() == 2 && loaderIn("c").find("gl:compatibility=3.3") != std::string::npos;
+    unsetenv("GLAD_RUNS");
+    if (!ok) {
+        std::cerr << "FAIL: Generator ran " << gladRuns() << " times, expected once per glad_api.\n";
+        return false;
+    }
+    std::cout << "PASS: Loader generated once per spec and reused across projects.\n";
+    return true;
+}
+
+bool test_lockfile_detects_stale_checkout() {
+    std::cout << "--- Test: Lockfile Detects Stale Checkout ---\n";
+    cleanupMockDepProject();
+    createUpstreams();
+    createMockDepDir();
+    Harbour::Project::DependencyManager dep;
+    bool ok = dep.checkDependencies(true);
+    Harbour::Project::Lockfile lock;
+    ok &= lock.read(Harbour::Project::Lockfile::FILE_NAME) && lock.getEntries().size() == 3;
+    std::string snapshot = ok ? lock.find("glfw")->snapshot : "";
+
+    // Same contents with a new mtime: accepted, snapshot refreshed
+    std::filesystem::last_write_time("external/glfw/CMakeLists.txt",
+                                     std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    ok &= dep.checkDependencies(true) && std::filesystem::exists("external/glfw/CMakeLists.txt");
+    ok &= lock.read(Harbour::Project::Lockfile::FILE_NAME) && lock.find("glfw")->snapshot != snapshot;
+
+    // Different contents: refetched from the store
+    std::filesystem::remove("external/glm/CMakeLists.txt");
+    std::ofstream("external/glm/CMakeLists.txt") << "tampered\n";
+    ok &= dep.checkDependencies(true, true);
+    std::ifstream restored("external/glm/CMakeLists.txt");
+    std::string line;
+    std::getline(restored, line);
+    ok &= line == "# GLM";
+    std::filesystem::current_path("../");
+    if (!ok) {
+        std::cerr << "FAIL: harbour.lock did not accept a touched tree or reject a modified one.\n";
+        return false;
+    }
+    std::cout << "PASS: Touched tree re-hashed and kept, modified tree refetched.\n";
+    return true;
+}
+
 int main() {
     std::cout << ">>> Running DependencyManager Class Tests <<<\n\n";
     bool all_ok = true;
     all_ok &= test_no_graphics();
+    all_ok &= test_parallel_fetch();
+    all_ok &= test_failure_cancels_others();
+    all_ok &= test_store_shared_offline();
+    all_ok &= test_loader_cached();
+    all_ok &= test_lockfile_detects_stale_checkout();
     std::cout << "\n-------------------------------------\n";
     if (all_ok) {
         std::cout << ">>> All DependencyManager tests passed successfully! <<<\n";
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_LOCK_ROOT = "mock_lockfile";
+
+void cleanupMockLock() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_LOCK_ROOT, ec);
+}
+
+bool test_round_trip() {
+    std::cout << "--- Test: Round Trip ---\n";
+    cleanupMockLock();
+    std::filesystem::create_directories(MOCK_LOCK_ROOT);
+    std::string path = (MOCK_LOCK_ROOT / "harbour.lock").string();
+    Harbour::Project::Lockfile lock;
+    if (!lock.read(path) || !lock.getEntries().empty()) {
+        std::cerr << "FAIL: A missing lockfile should read as empty.\n";
+        return false;
+    }
+    lock.set("glfw", {"https://example.com/glfw.git", "3.4", "abc123", "hash1", "snap1"});
+    lock.set("glm", {"file:///srv/glm", "1.0.1", "def456", "hash2", "snap2"});
+    Harbour::Project::Lockfile reread;
+    if (!lock.write(path) || !reread.read(path) || reread.getEntries().size() != 2 ||
+        reread.find("glfw")->url != "https://example.com/glfw.git" || reread.find("glm")->commit != "def456" ||
+        reread.find("glm")->snapshot != "snap2") {
+        std::cerr << "FAIL: Entries did not survive a write and read.\n";
+        return false;
+    }
+    std::cout << "PASS: Entries written and read back.\n";
+    return true;
+}
+
+bool test_hash_and_snapshot() {
+    std::cout << "--- Test: Hash And Snapshot ---\n";
+    cleanupMockLock();
+    auto tree = MOCK_LOCK_ROOT / "tree";
+    std::filesystem::create_directories(tree / "sub");
+    std::ofstream(tree / "a.txt") << "alpha\n";
+    std::ofstream(tree / "sub" / "b.txt") << "beta\n";
+    using Harbour::Project::Lockfile;
+    std::string hash = Lockfile::treeHash(tree.string());
+    std::string snapshot = Lockfile::statSnapshot(tree.string());
+
+    std::filesystem::last_write_time(tree / "a.txt",
+                                     std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+    bool ok = Lockfile::statSnapshot(tree.string()) != snapshot && Lockfile::treeHash(tree.string()) == hash;
+    std::ofstream(tree / "sub" / "b.txt") << "gamma\n";
+    ok &= Lockfile::treeHash(tree.string()) != hash;
+    if (!ok) {
+        std::cerr << "FAIL: Snapshot should track mtimes and the hash only contents.\n";
+        return false;
+    }
+    std::cout << "PASS: Snapshot follows metadata, hash follows contents.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running Lockfile Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_round_trip();
+    all_ok &= test_hash_and_snapshot();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Lockfile tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME LOCKFILE TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockLock();
+    return all_ok ? 0 : 1;
+}
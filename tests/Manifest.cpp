@@ -0,0 +1,78 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_MANIFEST_ROOT = "mock_manifest";
+
+void cleanupMockManifest() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_MANIFEST_ROOT, ec);
+}
+
+bool test_typed_model() {
+    std::cout << "--- Test: Typed Model ---\n";
+    Harbour::Project::Manifest manifest;
+    std::string error;
+    bool ok = manifest.parse(R"({
+        "info": {"name": "my\"project", "type": "binary", "version": "1.0.0"},
+        "scripts": {"run": "./bin/myproject", "install": ["echo Installing...", "cp a b"]},
+        "dependencies": {"glfw": "^3.3.8", "glm": "^0.9.9", "spdlog": "^1.11.0"}
+    })", error);
+    const auto *install = manifest.script("install");
+    if (!ok || manifest.name != "my\"project" || manifest.version != "1.0.0" || !install ||
+        install->commands.size() != 2 || manifest.script("run")->commands[0] != "./bin/myproject" ||
+        manifest.dependencies.size() != 3 || manifest.dependencies[2].first != "spdlog" ||
+        manifest.dependencies[0].second != "^3.3.8") {
+        std::cerr << "FAIL: Manifest fields do not match the document: " << error << "\n";
+        return false;
+    }
+    if (manifest.parse(R"({"dependencies": {"glfw": 3}})", error) || error.find("glfw") == std::string::npos) {
+        std::cerr << "FAIL: A non-string range was accepted.\n";
+        return false;
+    }
+    std::cout << "PASS: Info, scripts and dependencies exposed in order.\n";
+    return true;
+}
+
+bool test_loaded_with_config() {
+    std::cout << "--- Test: Loaded With Config ---\n";
+    cleanupMockManifest();
+    std::filesystem::create_directories(MOCK_MANIFEST_ROOT);
+    Harbour::Project::ConfigManager writer;
+    writer.writeConfig(MOCK_MANIFEST_ROOT.string(), "demo", 17, "bin", "lib", false, false, "");
+    Harbour::Project::ConfigManager plain;
+    bool ok = plain.readConfig(MOCK_MANIFEST_ROOT.string()) && !plain.hasManifest;
+
+    std::ofstream(MOCK_MANIFEST_ROOT / ".hrbr") << R"({"info": {"name": "demo"}, "dependencies": {"fmt": "~9.1"}})";
+    Harbour::Project::ConfigManager cfg;
+    ok &= cfg.readConfig(MOCK_MANIFEST_ROOT.string()) && cfg.hasManifest && cfg.manifest.name == "demo" &&
+          cfg.manifest.dependencies.size() == 1;
+
+    std::ofstream(MOCK_MANIFEST_ROOT / ".hrbr") << "{\"dependencies\": ";
+    Harbour::Project::ConfigManager broken;
+    ok &= !broken.readConfig(MOCK_MANIFEST_ROOT.string());
+    if (!ok) {
+        std::cerr << "FAIL: .hrbr was not loaded, or a broken one was accepted, alongside .harbourConfig.\n";
+        return false;
+    }
+    std::cout << "PASS: ConfigManager reads .hrbr next to .harbourConfig.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running Manifest Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_typed_model();
+    all_ok &= test_loaded_with_config();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Manifest tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME MANIFEST TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockManifest();
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_NATIVE_ROOT = "mock_native_project";
+
+void cleanupMockNativeProject() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_NATIVE_ROOT, ec);
+}
+
+bool buildNative() {
+    Harbour::Project::Builder builder;
+    Harbour::Project::BuildOptions options;
+    options.engine = "native";
+    return builder.buildProject(MOCK_NATIVE_ROOT.string(), false, false, options);
+}
+
+bool test_native_build() {
+    std::cout << "--- Test: Native Build ---\n";
+    cleanupMockNativeProject();
+    Harbour::Project::ProjectCreator creator;
+    if (!creator.createProject(MOCK_NATIVE_ROOT.string(), 17, "bin", "lib", false, false) || !buildNative()) {
+        std::cerr << "FAIL: Native build of a scaffolded project failed.\n";
+        return false;
+    }
+    if (!std::filesystem::exists(MOCK_NATIVE_ROOT / "build" / "release" / "bin" / MOCK_NATIVE_ROOT) ||
+        !std::filesystem::exists(MOCK_NATIVE_ROOT / "compile_commands.json")) {
+        std::cerr << "FAIL: Binary or compile_commands.json missing.\n";
+        return false;
+    }
+    std::cout << "PASS: Native engine produced the binary and compile_commands.json.\n";
+    return true;
+}
+
+bool test_incremental_rebuild() {
+    std::cout << "--- Test: Incremental Rebuild ---\n";
+    const auto object = MOCK_NATIVE_ROOT / "build" / "release" / "obj" / "src" / "main.cpp.o";
+    auto built = std::filesystem::last_write_time(object);
+    if (!buildNative() || std::filesystem::last_write_time(object) != built) {
+        std::cerr << "FAIL: Up-to-date unit was recompiled.\n";
+        return false;
+    }
+    // main.cpp includes comp.h, so touching the header must rebuild it
+    std::ofstream(MOCK_NATIVE_ROOT / "include" / "comp.h", std::ios::app) << "// touched\n";
+    std::filesystem::last_write_time(MOCK_NATIVE_ROOT / "include" / "comp.h",
+                                     built + std::chrono::seconds(1));
+    if (!buildNative() || std::filesystem::last_write_time(object) == built) {
+        std::cerr << "FAIL: Header change did not trigger a recompile.\n";
+        return false;
+    }
+    std::cout << "PASS: Only units with changed inputs were recompiled.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running NativeBuilder Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_native_build();
+    all_ok &= test_incremental_rebuild();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All NativeBuilder tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME NATIVEBUILDER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockNativeProject();
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "harbour.hpp"
+
+namespace fs = std::filesystem;
+
+// Runs a shell loop with counters attached; false if perf_event_open is
+// not allowed at all here
+bool countedRun(Harbour::Project::PerfCounters &counters, const std::string &script) {
+    bool attached = false;
+    Harbour::CommandExecutor exec;
+    Harbour::CommandExecutor::Options options;
+    options.onSpawn = [&](pid_t pid) { attached = counters.attach(pid); };
+    exec.run({"/bin/sh", "-c", script}, options);
+    counters.collect();
+    return attached;
+}
+
+bool test_counts_the_program() {
+    std::cout << "--- Test: Counts The Program ---\n";
+    Harbour::Project::PerfCounters counters;
+    if (!countedRun(counters, "i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done")) {
+        std::cout << "PASS: Skipped, perf_event_open is not permitted here.\n";
+        return true;
+    }
+    const auto &totals = counters.totals();
+    auto clock = totals.find("task-clock");
+    auto faults = totals.find("page-faults");
+    if (clock == totals.end() || clock->second <= 0 || faults == totals.end() || faults->second <= 0) {
+        std::cerr << "FAIL: Software counters were not read.\n";
+        return false;
+    }
+    if (counters.hardware() && !totals.count("cycles")) {
+        std::cerr << "FAIL: Hardware counters opened but cycles were not read.\n";
+        return false;
+    }
+    std::cout << "PASS: Counted the run (" << (counters.hardware() ? "hardware" : "software only") << ").\n";
+    return true;
+}
+
+bool test_per_thread_and_output() {
+    std::cout << "--- Test: Per-Thread Counts And Output File ---\n";
+    Harbour::Project::PerfCounters counters(true);
+    if (!countedRun(counters, "exit 0")) {
+        std::cout << "PASS: Skipped, perf_event_open is not permitted here.\n";
+        return true;
+    }
+    std::string file = (fs::temp_directory_path() / "harbour_perf_test.txt").string();
+    if (counters.threads().empty() || !counters.write(file)) {
+        std::cerr << "FAIL: No per-thread counts, or the output was not written.\n";
+        return false;
+    }
+    std::ifstream in(file);
+    std::stringstream text;
+    text << in.rdbuf();
+    fs::remove(file);
+    if (text.str().find("\ntask-clock=") == std::string::npos ||
+        text.str().find("\nthread.0.task-clock=") == std::string::npos) {
+        std::cerr << "FAIL: Output file is missing the totals or thread lines:\n" << text.str();
+        return false;
+    }
+    std::cout << "PASS: Main thread counted and written as name=value lines.\n";
+    return true;
+}
+
+bool test_derived_metrics() {
+    std::cout << "--- Test: Derived Metrics ---\n";
+    Harbour::Project::PerfCounters::Counts counts = {
+        {"cycles", 1000}, {"instructions", 2500}, {"branches", 200}, {"branch-misses", 10}, {"LLC-loads", 50}};
+    auto ratios = Harbour::Project::PerfCounters::derived(counts);
+    if (ratios["ipc"] != 2.5 || ratios["branch-miss-rate"] != 0.05 || ratios.count("LLC-miss-rate") ||
+        ratios.count("L1-dcache-miss-rate")) {
+        std::cerr << "FAIL: Wrong IPC or miss rates.\n";
+        return false;
+    }
+    std::cout << "PASS: IPC and miss rates only from counted inputs.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running PerfCounters Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_counts_the_program();
+    all_ok &= test_per_thread_and_output();
+    all_ok &= test_derived_metrics();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All PerfCounters tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME PERFCOUNTERS TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
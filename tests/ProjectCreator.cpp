@@ -24,6 +24,12 @@ bool test_create_success() {
         std::cerr << "FAIL: CMakeLists.txt not created.\n";
         return false;
     }
+    std::ifstream cmake(MOCK_PC_ROOT / "CMakeLists.txt");
+    std::string content((std::istreambuf_iterator<char>(cmake)), std::istreambuf_iterator<char>());
+    if (content.find("target_precompile_headers") == std::string::npos) {
+        std::cerr << "FAIL: CMakeLists.txt has no precompiled header hook.\n";
+        return false;
+    }
     std::cout << "PASS: Project created and CMakeLists.txt exists.\n";
     return true;
 }
@@ -0,0 +1,111 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+const std::filesystem::path MOCK_INDEX_ROOT = "mock_resolver";
+
+void cleanupMockIndex() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_INDEX_ROOT, ec);
+}
+
+void describe(const std::string &name, const std::string &versions) {
+    std::filesystem::create_directories(MOCK_INDEX_ROOT / "index");
+    std::ofstream(MOCK_INDEX_ROOT / "index" / (name + ".json")) << "{\"versions\": {" << versions << "}}";
+}
+
+// spdlog 1.12 wants fmt ^10, but app pins fmt ~9.1, so spdlog must back
+// off to 1.11 for the graph to resolve.
+void createIndex() {
+    describe("spdlog", R"("1.11.0": {"url": "file:///spdlog", "rev": "v1.11.0", "dependencies": {"fmt": "^9.1.0"}},
+                         "1.12.0": {"url": "file:///spdlog", "rev": "v1.12.0", "dependencies": {"fmt": "^10.0.0"}})");
+    describe("fmt", R"("9.1.0": {"rev": "9.1.0"}, "9.1.2": {"rev": "9.1.2"}, "10.1.1": {"rev": "10.1.1"})");
+    describe("glfw", R"("3.3.8": {}, "3.4.0": {"rev": "3.4"}, "4.0.0": {})");
+}
+
+const Harbour::Project::Resolver::Package *find(const std::vector<Harbour::Project::Resolver::Package> &packages,
+                                                const std::string &name) {
+    for (const auto &package : packages)
+        if (package.name == name) return &package;
+    return nullptr;
+}
+
+bool test_transitive_with_backtracking() {
+    std::cout << "--- Test: Transitive With Backtracking ---\n";
+    cleanupMockIndex();
+    createIndex();
+    Harbour::Project::Resolver resolver((MOCK_INDEX_ROOT / "index").string());
+    std::vector<Harbour::Project::Resolver::Package> packages;
+    std::string error;
+    bool ok = resolver.resolve({{"glfw", "^3.3.8"}, {"spdlog", "^1.11.0"}, {"fmt", "~9.1"}}, packages, error);
+    if (!ok || packages.size() != 3 || find(packages, "glfw")->version != "3.4.0" ||
+        find(packages, "glfw")->rev != "3.4" || find(packages, "spdlog")->version != "1.11.0" ||
+        find(packages, "fmt")->version != "9.1.2" || find(packages, "spdlog")->dependencies.size() != 1) {
+        std::cerr << "FAIL: Expected glfw 3.4.0, spdlog 1.11.0 and fmt 9.1.2: " << error << "\n";
+        return false;
+    }
+    packages.clear();
+    if (resolver.resolve({{"spdlog", "^1.12.0"}, {"fmt", "~9.1"}}, packages, error) ||
+        error.find("conflicts with") == std::string::npos) {
+        std::cerr << "FAIL: Unsatisfiable graph was not reported as a conflict.\n";
+        return false;
+    }
+    std::cout << "PASS: Newest compatible versions chosen, conflict explained: " << error << "\n";
+    return true;
+}
+
+bool test_lockfile_skips_resolution() {
+    std::cout << "--- Test: Lockfile Skips Resolution ---\n";
+    cleanupMockIndex();
+    createIndex();
+    std::filesystem::create_directories(MOCK_INDEX_ROOT / "project");
+    std::ofstream(MOCK_INDEX_ROOT / "project" / ".hrbr")
+        << R"({"info": {"name": "app"}, "dependencies": {"spdlog": "^1.11.0", "fmt": "~9.1"}})";
+    std::string lock = (MOCK_INDEX_ROOT / "project" / "hrbr.lock").string();
+    Harbour::Project::Resolver::Requirements requirements;
+    std::string error;
+    if (!Harbour::Project::Resolver::readManifest((MOCK_INDEX_ROOT / "project" / ".hrbr").string(), requirements,
+                                                  error) ||
+        requirements.size() != 2 || requirements[0].first != "spdlog") {
+        std::cerr << "FAIL: Manifest dependencies were not read in order: " << error << "\n";
+        return false;
+    }
+    std::vector<Harbour::Project::Resolver::Package> first, second;
+    bool fromLock = true;
+    Harbour::Project::Resolver resolver((MOCK_INDEX_ROOT / "index").string());
+    bool ok = resolver.resolveLocked(requirements, lock, first, error, &fromLock) && !fromLock;
+
+    // With the index gone, only the lockfile can answer
+    std::filesystem::remove_all(MOCK_INDEX_ROOT / "index");
+    Harbour::Project::Resolver offline((MOCK_INDEX_ROOT / "index").string());
+    ok &= offline.resolveLocked(requirements, lock, second, error, &fromLock) && fromLock &&
+          second.size() == first.size() && find(second, "fmt")->version == "9.1.2" &&
+          find(second, "spdlog")->dependencies == std::vector<std::string>{"fmt"};
+    // Changed requirements invalidate it
+    requirements.emplace_back("glfw", "^3.3.8");
+    ok &= !offline.resolveLocked(requirements, lock, second, error, &fromLock) && !fromLock;
+    if (!ok) {
+        std::cerr << "FAIL: hrbr.lock was not reused for identical requirements only: " << error << "\n";
+        return false;
+    }
+    std::cout << "PASS: Repeat resolution served from hrbr.lock without the index.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running Resolver Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_transitive_with_backtracking();
+    all_ok &= test_lockfile_skips_resolution();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Resolver tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME RESOLVER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockIndex();
+    return all_ok ? 0 : 1;
+}
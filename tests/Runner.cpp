@@ -37,9 +37,11 @@ void createFakeBinary(const std::string &type, bool should_succeed) {
 }
 
 void createConfigFile(const std::string &projectName) {
+  std::filesystem::create_directories(MOCK_PROJECT_ROOT);
   std::ofstream file(MOCK_PROJECT_ROOT / ".harbourConfig");
 
-  file << "{\"projectName\": \"" << projectName << "\"}";
+  file << "project_name=\"" << projectName << "\"\n";
+  file << "runtime_bin=\"bin\"\n";
   file.close();
 }
 
@@ -108,6 +110,31 @@ bool test_run_failure() {
   return true;
 }
 
+bool test_run_log() {
+  std::cout << "--- Test: Run Output Logged ---\n";
+  cleanupMockProject();
+  createConfigFile("MockApp");
+  createFakeBinary("release", false);
+  std::filesystem::path log = MOCK_PROJECT_ROOT / "run.log";
+
+  Harbour::Project::Runner runner;
+  Harbour::Project::RunOptions options;
+  options.logFile = log.string();
+  if (runner.runProject(MOCK_PROJECT_ROOT.string(), options)) {
+    std::cerr << "FAIL: runProject succeeded even when the binary failed.\n";
+    return false;
+  }
+  std::ifstream in(log);
+  std::string line;
+  std::getline(in, line);
+  if (line != "--- Running the release binary ---") {
+    std::cerr << "FAIL: The log did not hold the program's output.\n";
+    return false;
+  }
+  std::cout << "PASS: Output was written to the run log.\n";
+  return true;
+}
+
 int main() {
   std::cout << ">>> Running Runner Class Tests <<<\n\n";
   bool all_ok = true;
@@ -116,6 +143,7 @@ int main() {
   all_ok &= test_run_release_only();
   all_ok &= test_run_newer_debug();
   all_ok &= test_run_failure();
+  all_ok &= test_run_log();
 
   std::cout << "\n-------------------------------------\n";
   if (all_ok) {
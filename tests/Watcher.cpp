@@ -0,0 +1,93 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+
+using Change = Harbour::Project::Watcher::Change;
+
+const std::filesystem::path MOCK_WATCH_ROOT = "mock_watch_project";
+
+void cleanupMockWatch() {
+    std::error_code ec;
+    std::filesystem::remove_all(MOCK_WATCH_ROOT, ec);
+}
+
+void touch(const std::filesystem::path& file, const std::string& content = "// edit\n") {
+    std::ofstream out(file);
+    out << content;
+}
+
+void createMockProject() {
+    cleanupMockWatch();
+    std::filesystem::create_directories(MOCK_WATCH_ROOT / "src");
+    std::filesystem::create_directories(MOCK_WATCH_ROOT / "include");
+    touch(MOCK_WATCH_ROOT / "src" / "main.cpp", "int main() { return 0; }\n");
+    touch(MOCK_WATCH_ROOT / "CMakeLists.txt", "project(mock)\n");
+}
+
+bool test_classifies_changes() {
+    std::cout << "--- Test: Classifies Changes ---\n";
+    createMockProject();
+    Harbour::Project::Watcher watcher(MOCK_WATCH_ROOT.string(), false, {}, false, 50);
+    if (!watcher.start()) {
+        std::cerr << "FAIL: inotify watches could not be set up.\n";
+        return false;
+    }
+    touch(MOCK_WATCH_ROOT / "src" / "main.cpp");
+    if (watcher.waitForChanges(2000) != Change::Sources) {
+        std::cerr << "FAIL: Source edit was not reported as a source change.\n";
+        return false;
+    }
+    touch(MOCK_WATCH_ROOT / "src" / "main.cpp");
+    touch(MOCK_WATCH_ROOT / "CMakeLists.txt", "project(mock CXX)\n");
+    if (watcher.waitForChanges(2000) != Change::Config) {
+        std::cerr << "FAIL: CMakeLists.txt edit was not reported as a config change.\n";
+        return false;
+    }
+    touch(MOCK_WATCH_ROOT / "compile_commands.json", "[]\n");
+    touch(MOCK_WATCH_ROOT / "src" / ".main.cpp.swp");
+    touch(MOCK_WATCH_ROOT / "src" / "main.cpp~");
+    if (watcher.waitForChanges(300) != Change::None) {
+        std::cerr << "FAIL: Build output or editor files triggered a rebuild.\n";
+        return false;
+    }
+    std::cout << "PASS: Sources, config and noise told apart.\n";
+    return true;
+}
+
+bool test_debounce_and_new_directories() {
+    std::cout << "--- Test: Debounce And New Directories ---\n";
+    createMockProject();
+    Harbour::Project::Watcher watcher(MOCK_WATCH_ROOT.string(), false, {}, false, 100);
+    watcher.start();
+    std::filesystem::create_directories(MOCK_WATCH_ROOT / "src" / "sub");
+    for (int i = 0; i < 5; ++i) touch(MOCK_WATCH_ROOT / "src" / ("f" + std::to_string(i) + ".cpp"));
+    if (watcher.waitForChanges(2000) != Change::Sources || watcher.waitForChanges(200) != Change::None) {
+        std::cerr << "FAIL: A burst of writes was not folded into one change.\n";
+        return false;
+    }
+    touch(MOCK_WATCH_ROOT / "src" / "sub" / "nested.cpp");
+    if (watcher.waitForChanges(2000) != Change::Sources) {
+        std::cerr << "FAIL: Directory created after start() is not watched.\n";
+        return false;
+    }
+    std::cout << "PASS: Burst debounced and new subdirectory watched.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running Watcher Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_classifies_changes();
+    all_ok &= test_debounce_and_new_directories();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All Watcher tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME WATCHER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    cleanupMockWatch();
+    return all_ok ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <fstream>
 #include <filesystem>
+#include <thread>
 #include "harbour.hpp"
 
 
@@ -114,6 +115,61 @@ bool test_seeking_and_jumping() {
     return true;
 }
 
+bool test_line_index() {
+    std::cout << "--- Test: Indexed Line Jumps ---\n";
+    const std::filesystem::path testPath = "test_file.txt";
+    cleanupPath(testPath);
+
+    // Lines of every length around the 16 and 32 byte vector widths, some empty
+    std::vector<std::string> lines;
+    std::ofstream setup(testPath);
+    for (size_t i = 0; i < 5000; ++i) {
+        lines.push_back(std::string(i % 71, 'x') + (i % 5 ? std::to_string(i) : ""));
+        setup << lines.back() << (i + 1 < 5000 ? "\n" : "");
+    }
+    setup.close();
+
+    try {
+        Harbour::FH::fileHandler handler(testPath, "ra");
+        handler.open();
+        if (handler.lineCount() != lines.size()) {
+            std::cerr << "FAIL: lineCount() returned " << handler.lineCount() << ".\n";
+            return false;
+        }
+        std::string line;
+        for (size_t n : {4999, 1, 2500, 17, 5000, 33, 4999}) {
+            handler.jumpToLine(n);
+            std::getline(handler.getStream(), line);
+            if (line != lines[n - 1]) {
+                std::cerr << "FAIL: jumpToLine(" << n << ") read the wrong line.\n";
+                return false;
+            }
+        }
+        try {
+            handler.jumpToLine(5002);
+            std::cerr << "FAIL: Jumped past the end of the file.\n";
+            return false;
+        } catch (const std::runtime_error &) {
+        }
+        std::cout << "PASS: jumpToLine lands on the right line anywhere in the file.\n";
+
+        handler.getStream().clear();
+        handler.writeLines({"", "appended"});
+        handler.jumpToLine(5001);
+        std::getline(handler.getStream(), line);
+        if (line != "appended" || handler.lineCount() != 5001) {
+            std::cerr << "FAIL: The index was not rebuilt after a write.\n";
+            return false;
+        }
+        std::cout << "PASS: Writes invalidate the line index.\n";
+        handler.close();
+    } catch (const std::exception &e) {
+        std::cerr << "FAIL: An exception occurred: " << e.what() << "\n";
+        return false;
+    }
+    return true;
+}
+
 bool test_appending() {
     std::cout << "--- Test: Appending ---\n";
     const std::filesystem::path testPath = "test_file.txt";
@@ -175,6 +231,59 @@ bool test_directory_creation() {
     return true;
 }
 
+bool test_publish() {
+    std::cout << "--- Test: Publishing Beside the Final Name ---\n";
+    namespace fs = std::filesystem;
+    const fs::path dir = "temp_publish_dir";
+    cleanupPath(dir);
+    fs::create_directories(dir);
+    bool ok = true;
+
+    fs::path entry = dir / "entry";
+    fs::path tmp = Harbour::FH::tempSibling(entry);
+    fs::path otherThread;
+    std::thread([&] { otherThread = Harbour::FH::tempSibling(entry); }).join();
+    if (tmp.parent_path() != dir || tmp == entry || tmp == otherThread) {
+        std::cerr << "FAIL: tempSibling gave " << tmp << " and " << otherThread << "\n";
+        ok = false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(tmp);
+    std::ofstream(tmp / "file") << "first";
+    if (!Harbour::FH::publish(tmp, entry, ec) || getFileContent(entry / "file") != "first" || fs::exists(tmp)) {
+        std::cerr << "FAIL: Tree was not published\n";
+        ok = false;
+    }
+
+    // A second writer loses the race: its copy goes, the first one stays
+    fs::create_directories(tmp);
+    std::ofstream(tmp / "file") << "second";
+    if (!Harbour::FH::publish(tmp, entry, ec) || ec || getFileContent(entry / "file") != "first" ||
+        fs::exists(tmp)) {
+        std::cerr << "FAIL: Losing a publish race was not treated as success\n";
+        ok = false;
+    }
+
+    // Files are replaced, so a cache entry can be rewritten
+    fs::path file = dir / "value";
+    std::ofstream(file) << "old";
+    std::ofstream(Harbour::FH::tempSibling(file)) << "new";
+    if (!Harbour::FH::publish(Harbour::FH::tempSibling(file), file, ec) || getFileContent(file) != "new") {
+        std::cerr << "FAIL: File was not replaced\n";
+        ok = false;
+    }
+
+    if (Harbour::FH::publish(dir / "missing", dir / "nowhere", ec) || !ec) {
+        std::cerr << "FAIL: Publishing a missing file succeeded\n";
+        ok = false;
+    }
+
+    cleanupPath(dir);
+    if (ok) std::cout << "PASS: Entries appear whole and races resolve to the first\n";
+    return ok;
+}
+
 int main() {
     std::cout << ">>> Running fileHandler Tests <<<\n\n";
     bool all_ok = true;
@@ -182,8 +291,10 @@ int main() {
     all_ok &= test_creation_and_open();
     all_ok &= test_write_and_read();
     all_ok &= test_seeking_and_jumping();
+    all_ok &= test_line_index();
     all_ok &= test_appending();
     all_ok &= test_directory_creation();
+    all_ok &= test_publish();
 
     std::cout << "\n-------------------------------------\n";
     if (all_ok) {
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+#include "json.hpp"
+
+bool test_parse_document() {
+    std::cout << "--- Test: Parse Document ---\n";
+    std::string text = R"({"name": "glfw", "version": 3.4, "tags": ["a", "b\n"], "pinned": true, "extra": null})";
+    Harbour::Json::Value root;
+    if (!Harbour::Json::parse(text, root) || !root.isObject()) {
+        std::cerr << "FAIL: Valid document was rejected.\n";
+        return false;
+    }
+    const auto *tags = root.find("tags");
+    if (root.get("name") != "glfw" || root.find("version")->number != 3.4 || !tags || tags->items.size() != 2 ||
+        tags->items[1].str() != "b\n" || !root.find("pinned")->boolean || !root.find("extra")->isNull()) {
+        std::cerr << "FAIL: Parsed values do not match the document.\n";
+        return false;
+    }
+    std::cout << "PASS: Objects, arrays, strings, numbers and literals parsed.\n";
+    return true;
+}
+
+bool test_unescape() {
+    std::cout << "--- Test: Unescape ---\n";
+    if (Harbour::Json::unescape(R"(a\"b\\cé😀)") != "a\"b\\c\xc3\xa9\xf0\x9f\x98\x80") {
+        std::cerr << "FAIL: Escapes were not decoded to UTF-8.\n";
+        return false;
+    }
+    std::cout << "PASS: Escapes and surrogate pairs decoded.\n";
+    return true;
+}
+
+bool test_reject_malformed() {
+    std::cout << "--- Test: Reject Malformed ---\n";
+    const char *bad[] = {"{", "[1,]", "{\"a\" 1}", "\"open", "tru", "{} x", "-"};
+    for (const char *text : bad) {
+        Harbour::Json::Value root;
+        std::string error;
+        if (Harbour::Json::parse(text, root, &error) || error.empty()) {
+            std::cerr << "FAIL: Accepted malformed input: " << text << "\n";
+            return false;
+        }
+    }
+    std::cout << "PASS: Malformed documents rejected with an error.\n";
+    return true;
+}
+
+bool test_long_strings() {
+    std::cout << "--- Test: Long Strings ---\n";
+    // Escapes, the closing quote and control characters at every offset
+    // across the 16-byte scanning blocks
+    for (size_t len = 0; len < 48; ++len) {
+        for (size_t at = 0; at <= len; ++at) {
+            std::string body(len, 'x');
+            std::string escaped = body.substr(0, at) + "\\\"" + body.substr(at);
+            Harbour::Json::Value root;
+            if (!Harbour::Json::parse("[\"" + body + "\", \"" + escaped + "\"]", root) || root.items[0].raw != body ||
+                root.items[1].str() != body.substr(0, at) + "\"" + body.substr(at)) {
+                std::cerr << "FAIL: String of length " << len << " with an escape at " << at << " misparsed.\n";
+                return false;
+            }
+            std::string control = body.substr(0, at) + "\n" + body.substr(at);
+            if (Harbour::Json::parse("\"" + control + "\"", root)) {
+                std::cerr << "FAIL: Raw newline at " << at << " was accepted.\n";
+                return false;
+            }
+        }
+    }
+    std::cout << "PASS: Block-wise string scanning matches byte-wise rules.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running json Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_parse_document();
+    all_ok &= test_unescape();
+    all_ok &= test_reject_malformed();
+    all_ok &= test_long_strings();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All json tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME JSON TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
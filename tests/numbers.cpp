@@ -0,0 +1,59 @@
+#include <iostream>
+#include "numbers.hpp"
+
+bool test_integers() {
+    std::cout << "--- Test: Integers ---\n";
+    long long value = 7;
+    bool ok = Harbour::Numbers::parseInteger("42", 1, 100, value) && value == 42 &&
+              Harbour::Numbers::parseInteger("+8", 1, 100, value) && value == 8 &&
+              Harbour::Numbers::parseInteger("-3", -5, 5, value) && value == -3;
+    if (!ok) {
+        std::cerr << "FAIL: A valid integer was rejected.\n";
+        return false;
+    }
+    for (const char *bad : {"", "foo", "4x", " 4", "0", "101", "-1", "+", "99999999999999999999"}) {
+        if (Harbour::Numbers::parseInteger(bad, 1, 100, value)) {
+            std::cerr << "FAIL: \"" << bad << "\" was accepted.\n";
+            return false;
+        }
+    }
+    if (value != -3) {
+        std::cerr << "FAIL: A rejected value overwrote the output.\n";
+        return false;
+    }
+    std::cout << "PASS: Integers parsed whole and within range.\n";
+    return true;
+}
+
+bool test_decimals() {
+    std::cout << "--- Test: Decimals ---\n";
+    double value = 0;
+    if (!Harbour::Numbers::parseDecimal("2.5", 0, 100, value) || value != 2.5 ||
+        !Harbour::Numbers::parseDecimal("10", 0, 100, value) || value != 10) {
+        std::cerr << "FAIL: A valid decimal was rejected.\n";
+        return false;
+    }
+    for (const char *bad : {"", "abc", "1.5%", "-1", "1e3", "nan", "inf", "101"}) {
+        if (Harbour::Numbers::parseDecimal(bad, 0, 100, value)) {
+            std::cerr << "FAIL: \"" << bad << "\" was accepted.\n";
+            return false;
+        }
+    }
+    std::cout << "PASS: Decimals parsed whole and within range.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running numbers Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_integers();
+    all_ok &= test_decimals();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All numbers tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME NUMBERS TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
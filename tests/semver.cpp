@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include "harbour.hpp"
+#include "semver.hpp"
+
+bool matches(const std::string &range, const std::string &version) {
+    Harbour::Semver::Range r;
+    Harbour::Semver::Version v;
+    return Harbour::Semver::parseRange(range, r) && Harbour::Semver::parseVersion(version, v) && r.satisfies(v);
+}
+
+bool test_version_order() {
+    std::cout << "--- Test: Version Order ---\n";
+    const char *ascending[] = {"0.9.9", "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta.2",
+                               "1.0.0-beta.11", "1.0.0-rc.1", "1.0.0", "1.0.1", "1.10.0", "v2.0.0+build.5"};
+    Harbour::Semver::Version prev, cur;
+    for (size_t i = 0; i < sizeof(ascending) / sizeof(*ascending); ++i) {
+        if (!Harbour::Semver::parseVersion(ascending[i], cur) || (i > 0 && !(prev < cur))) {
+            std::cerr << "FAIL: " << ascending[i] << " did not parse or sort after " << prev.str() << ".\n";
+            return false;
+        }
+        prev = cur;
+    }
+    Harbour::Semver::Version v;
+    if (Harbour::Semver::parseVersion("1.2", v) || Harbour::Semver::parseVersion("1.2.3-", v)) {
+        std::cerr << "FAIL: Incomplete versions were accepted.\n";
+        return false;
+    }
+    std::cout << "PASS: Precedence follows semver 2.0.\n";
+    return true;
+}
+
+bool test_ranges() {
+    std::cout << "--- Test: Ranges ---\n";
+    struct Case {
+        const char *range, *version;
+        bool expected;
+    } cases[] = {
+        {"^3.3.8", "3.4.0", true},  {"^3.3.8", "3.3.7", false},    {"^3.3.8", "4.0.0", false},
+        {"^0.9.9", "0.9.12", true}, {"^0.9.9", "0.10.0", false},   {"^0.0.3", "0.0.4", false},
+        {"~1.2.3", "1.2.9", true},  {"~1.2.3", "1.3.0", false},    {"~1", "1.9.0", true},
+        {"1.2.x", "1.2.7", true},   {"1.2", "1.3.0", false},       {"*", "42.0.0", true},
+        {">= 1.0.0 <1.4", "1.3.9", true}, {">=1.0.0 <1.4", "1.4.0", false},
+        {"^1.0.0 || ^2.0.0", "2.5.0", true}, {"^1.0.0", "1.5.0-rc.1", false},
+        {"^1.5.0-rc.1", "1.5.0-rc.2", true}, {"=1.2.3", "1.2.3", true}, {">1.2", "1.2.9", false},
+    };
+    for (const auto &c : cases) {
+        if (matches(c.range, c.version) != c.expected) {
+            std::cerr << "FAIL: " << c.version << (c.expected ? " should" : " should not") << " satisfy " << c.range
+                      << ".\n";
+            return false;
+        }
+    }
+    Harbour::Semver::Range r;
+    if (Harbour::Semver::parseRange("^banana", r)) {
+        std::cerr << "FAIL: Garbage range was accepted.\n";
+        return false;
+    }
+    std::cout << "PASS: Caret, tilde, wildcard, comparator and prerelease rules hold.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running semver Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_version_order();
+    all_ok &= test_ranges();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All semver tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME SEMVER TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "stats.hpp"
+
+bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+bool test_median_and_mad() {
+    std::cout << "--- Test: Median And MAD ---\n";
+    std::vector<double> odd = {5, 1, 3, 100, 2};
+    std::vector<double> even = {4, 1, 3, 2};
+    if (!near(Harbour::Stats::median(odd), 3) || !near(Harbour::Stats::median(even), 2.5) ||
+        !near(Harbour::Stats::median({}), 0)) {
+        std::cerr << "FAIL: Wrong median.\n";
+        return false;
+    }
+    // Deviations from 3 are 2, 2, 0, 97, 1; the outlier does not move the MAD
+    if (!near(Harbour::Stats::mad(odd), 2)) {
+        std::cerr << "FAIL: Wrong MAD: " << Harbour::Stats::mad(odd) << "\n";
+        return false;
+    }
+    std::cout << "PASS: Median and MAD ignore the outlier.\n";
+    return true;
+}
+
+bool test_median_interval() {
+    std::cout << "--- Test: Median Interval ---\n";
+    std::vector<double> samples;
+    for (int i = 100; i >= 1; --i) samples.push_back(i);
+    auto ci = Harbour::Stats::medianInterval(samples);
+    // n=100: ranks 50 -/+ 9.8 give the 41st and 60th order statistics
+    if (!near(ci.low, 41) || !near(ci.high, 60)) {
+        std::cerr << "FAIL: Expected [41, 60], got [" << ci.low << ", " << ci.high << "].\n";
+        return false;
+    }
+    auto few = Harbour::Stats::medianInterval({3, 1, 2});
+    if (!near(few.low, 1) || !near(few.high, 3)) {
+        std::cerr << "FAIL: Three samples should span their full range.\n";
+        return false;
+    }
+    std::cout << "PASS: Order-statistic interval brackets the median.\n";
+    return true;
+}
+
+bool test_probability_greater() {
+    std::cout << "--- Test: Mann-Whitney ---\n";
+    std::vector<double> before = {10.1, 10.3, 9.9, 10.0, 10.2, 10.1, 9.8, 10.0};
+    std::vector<double> slower = {11.0, 11.2, 10.9, 11.1, 11.3, 11.0, 10.8, 11.1};
+    std::vector<double> same = {10.0, 10.2, 9.9, 10.1, 10.3, 10.0, 9.8, 10.1};
+    double pSlower = Harbour::Stats::probabilityGreater(before, slower);
+    double pSame = Harbour::Stats::probabilityGreater(before, same);
+    double pFaster = Harbour::Stats::probabilityGreater(slower, before);
+    double pTied = Harbour::Stats::probabilityGreater({5, 5, 5}, {5, 5, 5});
+    if (!(pSlower < 0.001) || !(pSame > 0.2) || !(pFaster > 0.999) || !near(pTied, 1)) {
+        std::cerr << "FAIL: p-values " << pSlower << ", " << pSame << ", " << pFaster << ", " << pTied << ".\n";
+        return false;
+    }
+    std::cout << "PASS: Only the shifted samples are significant.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running stats Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_median_and_mad();
+    all_ok &= test_median_interval();
+    all_ok &= test_probability_greater();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All stats tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME STATS TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
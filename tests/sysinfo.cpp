@@ -0,0 +1,46 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include "harbour.hpp"
+#include "sysinfo.hpp"
+
+bool test_usable_cores() {
+    std::cout << "--- Test: Usable Cores ---\n";
+    unsigned cores = Harbour::Sys::usableCores();
+    unsigned hw = std::thread::hardware_concurrency();
+    if (cores < 1 || (hw > 0 && cores > hw)) {
+        std::cerr << "FAIL: usableCores() returned " << cores << " (hardware: " << hw << ").\n";
+        return false;
+    }
+    std::cout << "PASS: usableCores() returned " << cores << ".\n";
+    return true;
+}
+
+bool test_find_program() {
+    std::cout << "--- Test: Find Program ---\n";
+    if (Harbour::Sys::findProgram("sh").empty()) {
+        std::cerr << "FAIL: sh was not found on PATH.\n";
+        return false;
+    }
+    if (!Harbour::Sys::findProgram("harbour-no-such-program").empty()) {
+        std::cerr << "FAIL: Found a program that does not exist.\n";
+        return false;
+    }
+    std::cout << "PASS: findProgram resolves PATH entries correctly.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running sysinfo Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_usable_cores();
+    all_ok &= test_find_program();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All sysinfo tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME SYSINFO TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    return all_ok ? 0 : 1;
+}
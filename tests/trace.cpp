@@ -0,0 +1,91 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "harbour.hpp"
+#include "trace.hpp"
+
+const std::filesystem::path TRACE_FILE = "test_trace.json";
+
+bool test_scope_records_duration() {
+    std::cout << "--- Test: Scope Records Duration ---\n";
+    auto &recorder = Harbour::Trace::Recorder::instance();
+    recorder.clear();
+    {
+        Harbour::Trace::Scope scope("sleep", "phase");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    auto events = recorder.events();
+    if (events.size() != 1 || events[0].name != "sleep" || events[0].durationUs < 20000) {
+        std::cerr << "FAIL: Scope did not record a single event of at least 20ms.\n";
+        return false;
+    }
+    std::cout << "PASS: Scope recorded its lifetime.\n";
+    return true;
+}
+
+bool test_command_events() {
+    std::cout << "--- Test: Commands Are Traced ---\n";
+    auto &recorder = Harbour::Trace::Recorder::instance();
+    recorder.clear();
+    Harbour::CommandExecutor exec;
+    exec.run({"/bin/true"}, true);
+    auto events = recorder.events();
+    if (events.size() != 1 || events[0].category != "command") {
+        std::cerr << "FAIL: CommandExecutor::run was not traced.\n";
+        return false;
+    }
+    bool costed = false;
+    for (const auto &[key, value] : events[0].args) costed |= key == "cpu_ms";
+    if (!costed) {
+        std::cerr << "FAIL: The command event carries no cost.\n";
+        return false;
+    }
+    std::cout << "PASS: CommandExecutor::run recorded a command event with its cost.\n";
+    return true;
+}
+
+bool test_chrome_trace() {
+    std::cout << "--- Test: Chrome Trace Export ---\n";
+    auto &recorder = Harbour::Trace::Recorder::instance();
+    recorder.clear();
+    {
+        Harbour::Trace::Scope scope("quoted \"name\"", "phase");
+        scope.arg("max_rss_kb", 1234);
+    }
+    if (!recorder.writeChromeTrace(TRACE_FILE)) {
+        std::cerr << "FAIL: Could not write the trace file.\n";
+        return false;
+    }
+    std::ifstream in(TRACE_FILE);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (content.find("\"traceEvents\"") == std::string::npos ||
+        content.find("\"ph\":\"X\"") == std::string::npos ||
+        content.find("quoted \\\"name\\\"") == std::string::npos ||
+        content.find("\"args\":{\"max_rss_kb\":1234}") == std::string::npos) {
+        std::cerr << "FAIL: Trace file is not in trace-event format.\n";
+        return false;
+    }
+    std::cout << "PASS: Trace written in Chrome trace-event format.\n";
+    return true;
+}
+
+int main() {
+    std::cout << ">>> Running trace Tests <<<\n\n";
+    bool all_ok = true;
+    all_ok &= test_scope_records_duration();
+    all_ok &= test_command_events();
+    all_ok &= test_chrome_trace();
+    std::cout << "\n-------------------------------------\n";
+    if (all_ok) {
+        std::cout << ">>> All trace tests passed successfully! <<<\n";
+    } else {
+        std::cout << ">>> SOME TRACE TESTS FAILED! <<<\n";
+    }
+    std::cout << "-------------------------------------\n";
+    std::error_code ec;
+    std::filesystem::remove(TRACE_FILE, ec);
+    return all_ok ? 0 : 1;
+}